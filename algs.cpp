@@ -55,8 +55,11 @@ public:
 // the given start vertex.  Returns a vector of vertices in
 // the order they were visited, along with a map of (string,int)
 // pairs where the string is a vertex V and the int is the 
-// distance from the start vertex to V; if no such path exists,
-// the distance is INF (defined in util.h).
+// distance from the start vertex to V.  Only vertices the search
+// reaches are put in distances and predecessors, so the setup does
+// not cost O(N): a vertex missing from distances is unreachable,
+// i.e. its distance is INF (defined in algs.h).  Route queries over
+// the frozen graph should use the csrgraph versions in algs.h.
 //
 vector<long long> Dijkstra(graph<long long, double>& G,
   long long startV,
@@ -70,20 +73,26 @@ vector<long long> Dijkstra(graph<long long, double>& G,
     prioritize>   unvisitedQueue;
 
   //
-  // initialize data structures are per Dijkstra's alg:
+  // distance of v so far, INF if the search has not reached it:
   //
-  auto vertices = G.getVertices();
-  for (auto v : vertices)
+  auto distanceOf = [&distances](long long v)
   {
-    unvisitedQueue.push(make_pair(v, INF));
-    distances[v] = INF;
-    predecessors[v] = -1;  // an invalid vertex:
-  }
+    auto found = distances.find(v);
+
+    return (found == distances.end()) ? INF : found->second;
+  };
+
+  //
+  // only the vertices the search reaches go into the maps:
+  //
+  distances.clear();
+  predecessors.clear();
 
   //
   // we start from startV:
   //
   distances[startV] = 0;
+  predecessors[startV] = -1;  // an invalid vertex:
   //
   // whenever we update the distances array, we also need
   // to update the priority queue:
@@ -107,7 +116,7 @@ vector<long long> Dijkstra(graph<long long, double>& G,
     // is currV reachable from src?  If not, there's no point
     // in continuing alg:
     //
-    if (distances[currV] == INF)  // unreachable:
+    if (distanceOf(currV) == INF)  // unreachable:
       break;
     else if (kvpair.second == INF)  // remaining vertices in queue all INF:
       break;
@@ -120,23 +129,16 @@ vector<long long> Dijkstra(graph<long long, double>& G,
     }
 
     //
-    // visit adjacent nodes:
+    // visit adjacent nodes, weights come along with each neighbor
+    // so there is no separate getWeight lookup:
     //
-    auto adjacent = G.neighbors(currV);
+    double currDist = distances[currV];
 
-    for (auto adjV : adjacent)
+    G.forEachNeighbor(currV, [&](long long adjV, double weight)
     {
-      double weight;
+      double altDist = currDist + weight;
 
-      if (!G.getWeight(currV, adjV, weight))
-      {
-        cout << "**Error: internal error, unable to obtain weight?" << endl;
-        continue;
-      }
-
-      double altDist = distances[currV] + weight;
-
-      if (altDist < distances[adjV])  // found a less-expensive path:
+      if (altDist < distanceOf(adjV))  // found a less-expensive path:
       {
         //
         // update distances, and update priority queue:
@@ -145,7 +147,7 @@ vector<long long> Dijkstra(graph<long long, double>& G,
         unvisitedQueue.push(make_pair(adjV, altDist));
         predecessors[adjV] = currV;
       }
-    }
+    });
 
   }//while
 
@@ -12,9 +12,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <queue>
+#include <algorithm>
+#include <utility>  /*pair*/
 #include <limits>
+#include <cmath>
 
 #include "graph.h"
+#include "csrgraph.h"
 
 using namespace std;
 
@@ -24,3 +29,829 @@ vector<long long> Dijkstra(graph<long long, double>& G,
   long long startV,
   map<long long, double>& distances,
   map<long long, long long>& predecessors);
+
+
+//
+// Searches over a frozen csrgraph.
+//
+// These work on the graph's dense indices (see csrgraph.h): distances
+// and predecessors are indexed by G.indexOf(v), and -1 is used for
+// "no predecessor".  When the graph's vertices are already 0..N-1
+// (see idmap.h) the index of a vertex is the vertex itself.
+//
+
+//
+// SearchWorkspace:
+//
+// Distances, predecessors, visited markers and queue storage for one
+// search at a time.  Keep one workspace per thread and pass it to every
+// query: the arrays are allocated once and then reused, and reset() is
+// O(1) because each entry carries the generation of the search that
+// last wrote it.  Entries from older searches read back as distance INF
+// with no predecessor, so a short query only touches the part of the
+// map it explores.
+//
+class SearchWorkspace
+{
+private:
+  vector<double>    Distances;     // [index] = tentative distance
+  vector<int>       Predecessors;  // [index] = previous index on the path
+  vector<unsigned>  Touched;       // [index] == Generation if reached
+  vector<unsigned>  Settled;       // [index] == Generation if settled
+  unsigned          Generation;    // stamp of the current search
+
+  vector<pair<int, double>>  Heap;  // queue storage, kept between searches
+
+public:
+  SearchWorkspace()
+  {
+    Generation = 0;
+  }
+
+  //
+  // reset: starts a new search over a graph with numVertices vertices.
+  // Every vertex is back to INF, but nothing is cleared unless the
+  // arrays have to grow or the generation counter wraps around.
+  //
+  void reset(int numVertices)
+  {
+    if ((int) Touched.size() < numVertices)
+    {
+      Distances.resize(numVertices);
+      Predecessors.resize(numVertices);
+      Touched.resize(numVertices, 0);
+      Settled.resize(numVertices, 0);
+    }
+
+    Generation++;
+
+    if (Generation == 0)  // wrapped, old stamps could look current:
+    {
+      fill(Touched.begin(), Touched.end(), 0);
+      fill(Settled.begin(), Settled.end(), 0);
+      Generation = 1;
+    }
+
+    Heap.clear();
+  }
+
+  double distance(int index) const
+  {
+    return (Touched[index] == Generation) ? Distances[index] : INF;
+  }
+
+  int predecessor(int index) const
+  {
+    return (Touched[index] == Generation) ? Predecessors[index] : -1;
+  }
+
+  bool settled(int index) const
+  {
+    return Settled[index] == Generation;
+  }
+
+  //
+  // update: record a (better) tentative distance for index
+  //
+  void update(int index, double distance, int predecessor)
+  {
+    Distances[index] = distance;
+    Predecessors[index] = predecessor;
+    Touched[index] = Generation;
+  }
+
+  //
+  // relax: records distance for index if it improves on the current
+  // one, and returns true if it did.  Untouched vertices start at INF.
+  //
+  bool relax(int index, double distance, int predecessor)
+  {
+    if (distance < this->distance(index))
+    {
+      update(index, distance, predecessor);
+      return true;
+    }
+
+    return false;
+  }
+
+  void settle(int index)
+  {
+    Settled[index] = Generation;
+  }
+
+  //
+  // unsettle: puts a settled vertex back in play, for searches that
+  // may need to revisit a vertex (see AStarPath)
+  //
+  void unsettle(int index)
+  {
+    Settled[index] = Generation - 1;
+  }
+
+  //
+  // heap: (index, distance) queue storage for the current search, see
+  // DijkstraSearch.  Emptied by reset() but its capacity is kept.
+  //
+  vector<pair<int, double>>& heap()
+  {
+    return Heap;
+  }
+};
+
+//
+// function object that given two (index, distance) pairs, will
+// prioritize the smaller distance, breaking ties on the smaller index
+//
+class prioritizeIndex
+{
+public:
+  bool operator()(const pair<int, double>& p1,
+                  const pair<int, double>& p2) const
+  {
+    if (p1.second > p2.second)
+      return true;
+    else if (p1.second < p2.second)
+      return false;
+    else  // values are the same, decide based on indices:
+      return p1.first > p2.first;
+  }
+};
+
+
+//
+// BinaryHeapQueue:
+//
+// The default queue policy for DijkstraSearch: a binary heap of
+// (index, distance) pairs ordered by prioritizeIndex, kept in a vector
+// the caller owns (normally SearchWorkspace::heap()) so its storage is
+// reused.  There is no decrease-key: push adds another entry and the
+// stale ones are skipped when they come off the heap because their
+// vertex is already settled.
+//
+// Any class with the same four functions can be used in its place:
+// IndexedDaryHeap (daryheap.h), PairingHeap (pairingheap.h),
+// RadixHeapQueue (radixheap.h) and BucketQueue (bucketqueue.h).  The
+// queue is a template parameter, so each choice is compiled into its own
+// fully inlined search; benchmark.cpp times them against each other.
+//
+class BinaryHeapQueue
+{
+private:
+  vector<pair<int, double>>&  Heap;
+  prioritizeIndex             prioritize;
+
+public:
+  explicit BinaryHeapQueue(vector<pair<int, double>>& storage)
+    : Heap(storage)
+  {
+  }
+
+  void clear(int /*numVertices*/)
+  {
+    Heap.clear();
+  }
+
+  bool empty() const
+  {
+    return Heap.empty();
+  }
+
+  //
+  // push: index's tentative distance has improved to distance
+  //
+  void push(int index, double distance)
+  {
+    Heap.push_back(make_pair(index, distance));
+    push_heap(Heap.begin(), Heap.end(), prioritize);
+  }
+
+  //
+  // pop: removes and returns the entry with the smallest distance
+  //
+  pair<int, double> pop()
+  {
+    pop_heap(Heap.begin(), Heap.end(), prioritize);
+    pair<int, double> top = Heap.back();
+    Heap.pop_back();
+
+    return top;
+  }
+};
+
+
+//
+// DijkstraSettle:
+//
+// The main loop shared by the csrgraph searches, for a queue that has
+// already been seeded: state is reset and every start vertex has its
+// distance recorded and is pushed.  Settles vertices in (distance,
+// index) order and calls done(index, distance) for each one as it is
+// settled, before its edges are relaxed; the search stops as soon as
+// done returns true or the queue runs out.
+//
+template<typename VertexT, typename QueueT, typename DoneT>
+void DijkstraSettle(const csrgraph<VertexT, double>& G,
+  SearchWorkspace& state,
+  QueueT& unvisitedQueue,
+  DoneT done)
+{
+  while (!unvisitedQueue.empty())
+  {
+    auto kvpair = unvisitedQueue.pop();
+
+    int currV = kvpair.first;
+
+    if (state.settled(currV))  // already visited?
+      continue;  // if so, skip
+
+    state.settle(currV);
+
+    double currDist = kvpair.second;
+
+    if (done(currV, currDist))
+      break;
+
+    //
+    // visit adjacent nodes straight out of the CSR arrays:
+    //
+    for (int e = G.edgesBegin(currV); e < G.edgesEnd(currV); e++)
+    {
+      int adjV = G.edgeTarget(e);
+      double altDist = currDist + G.edgeWeight(e);
+
+      if (state.relax(adjV, altDist, currV))  // found a less-expensive path:
+      {
+        unvisitedQueue.push(adjV, altDist);
+      }
+    }
+  }//while
+}
+
+
+//
+// DijkstraSearch:
+//
+// Shared core of the csrgraph searches.  Runs Dijkstra from startIndex,
+// appending each index to visited as it is settled.  If targetIndex is
+// not -1, the search stops as soon as targetIndex is settled; otherwise
+// it runs until every reachable vertex has been settled.
+//
+// Nothing is initialized up front: the queue starts with just the start
+// vertex and the workspace is reset in O(1), so the work done is
+// proportional to the vertices touched, not to G.NumVertices().
+//
+// queue is the priority queue policy (see BinaryHeapQueue).  Every
+// policy pops vertices in the same (distance, index) order, so they all
+// produce the same distances, predecessors and visiting order.  Without
+// one, a binary heap in state.heap() is used.
+//
+template<typename VertexT, typename QueueT>
+void DijkstraSearch(const csrgraph<VertexT, double>& G,
+  int startIndex,
+  int targetIndex,
+  SearchWorkspace& state,
+  QueueT& unvisitedQueue,
+  vector<int>& visited)
+{
+  state.reset(G.NumVertices());
+  unvisitedQueue.clear(G.NumVertices());
+
+  //
+  // we start from startIndex:
+  //
+  state.update(startIndex, 0, -1);
+  unvisitedQueue.push(startIndex, 0);
+
+  //
+  // run algorithm until no more vertices to visit, or we reach
+  // the target (its distance is final once it is settled):
+  //
+  DijkstraSettle(G, state, unvisitedQueue,
+    [&visited, targetIndex](int index, double /*distance*/)
+    {
+      visited.push_back(index);
+
+      return index == targetIndex;
+    });
+}
+
+template<typename VertexT>
+void DijkstraSearch(const csrgraph<VertexT, double>& G,
+  int startIndex,
+  int targetIndex,
+  SearchWorkspace& state,
+  vector<int>& visited)
+{
+  BinaryHeapQueue  unvisitedQueue(state.heap());
+
+  DijkstraSearch(G, startIndex, targetIndex, state, unvisitedQueue, visited);
+}
+
+
+//
+// Dijkstra:
+//
+// Single-source version: settles every vertex reachable from startV
+// and returns them in the order they were visited.  distances[i] is
+// the distance from startV to G.vertexAt(i), or INF if unreachable.
+// If startV is not in the graph, nothing is visited.  state (and queue,
+// see DijkstraSearch) are the caller's reusable workspace.
+//
+template<typename VertexT, typename QueueT>
+vector<VertexT> Dijkstra(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  vector<double>& distances,
+  vector<int>& predecessors,
+  SearchWorkspace& state,
+  QueueT& queue)
+{
+  vector<int>      visitedIndices;
+  vector<VertexT>  visited;
+  int startIndex = G.indexOf(startV);
+
+  distances.assign(G.NumVertices(), INF);
+  predecessors.assign(G.NumVertices(), -1);
+
+  if (startIndex < 0)
+    return visited;
+
+  DijkstraSearch(G, startIndex, -1, state, queue, visitedIndices);
+
+  //
+  // a full search settles everything it touches, so the visited
+  // vertices are exactly the ones with a distance:
+  //
+  for (int index : visitedIndices)
+  {
+    distances[index] = state.distance(index);
+    predecessors[index] = state.predecessor(index);
+    visited.push_back(G.vertexAt(index));
+  }
+
+  return visited;
+}
+
+template<typename VertexT>
+vector<VertexT> Dijkstra(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  vector<double>& distances,
+  vector<int>& predecessors,
+  SearchWorkspace& state)
+{
+  BinaryHeapQueue  queue(state.heap());
+
+  return Dijkstra(G, startV, distances, predecessors, state, queue);
+}
+
+template<typename VertexT>
+vector<VertexT> Dijkstra(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  vector<double>& distances,
+  vector<int>& predecessors)
+{
+  SearchWorkspace  state;
+
+  return Dijkstra(G, startV, distances, predecessors, state);
+}
+
+
+//
+// DijkstraPath:
+//
+// Point-to-point version: stops as soon as destV is settled instead
+// of settling the whole graph.  Returns the distance from startV to
+// destV and fills path with the vertices from startV to destV in
+// order.  If destV is unreachable (or either vertex is missing), INF
+// is returned and path is left empty.  state (and queue, see
+// DijkstraSearch) are the caller's reusable workspace.
+//
+template<typename VertexT, typename QueueT>
+double DijkstraPath(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  VertexT destV,
+  vector<VertexT>& path,
+  SearchWorkspace& state,
+  QueueT& queue)
+{
+  vector<int>  visited;
+  int startIndex = G.indexOf(startV);
+  int destIndex = G.indexOf(destV);
+
+  path.clear();
+
+  if (startIndex < 0 || destIndex < 0)
+    return INF;
+
+  DijkstraSearch(G, startIndex, destIndex, state, queue, visited);
+
+  if (!state.settled(destIndex))  // unreachable:
+    return INF;
+
+  //
+  // walk the predecessors back from the destination, then reverse:
+  //
+  for (int index = destIndex; index != -1; index = state.predecessor(index))
+  {
+    path.push_back(G.vertexAt(index));
+  }
+
+  reverse(path.begin(), path.end());
+
+  return state.distance(destIndex);
+}
+
+template<typename VertexT>
+double DijkstraPath(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  VertexT destV,
+  vector<VertexT>& path,
+  SearchWorkspace& state)
+{
+  BinaryHeapQueue  queue(state.heap());
+
+  return DijkstraPath(G, startV, destV, path, state, queue);
+}
+
+template<typename VertexT>
+double DijkstraPath(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  VertexT destV,
+  vector<VertexT>& path)
+{
+  SearchWorkspace  state;
+
+  return DijkstraPath(G, startV, destV, path, state);
+}
+
+
+//
+// DijkstraSeededPath:
+//
+// Shortest path between two virtual vertices that are not in G, e.g.
+// points part way along an edge.  The start is joined to each
+// starts[i].first by an edge of weight starts[i].second, and each
+// targets[j].first is joined to the end by an edge of weight
+// targets[j].second; G itself is left alone.  Returns the length of
+// the shortest such path and fills path with the vertices of G along
+// it (the virtual ends are not included).  Returns INF with an empty
+// path if no target can be reached.  Ties go to the earlier target.
+//
+// The queue is seeded with every start and then run by DijkstraSettle
+// until the next distance is no shorter than the best way to the end
+// found so far.  state and queue are as in DijkstraSearch.
+//
+template<typename VertexT, typename QueueT>
+double DijkstraSeededPath(const csrgraph<VertexT, double>& G,
+  const vector<pair<VertexT, double>>& starts,
+  const vector<pair<VertexT, double>>& targets,
+  vector<VertexT>& path,
+  SearchWorkspace& state,
+  QueueT& unvisitedQueue)
+{
+  vector<int>  targetIndices;
+  double  best = INF;  // shortest way to the end through a settled target
+
+  path.clear();
+
+  state.reset(G.NumVertices());
+  unvisitedQueue.clear(G.NumVertices());
+
+  //
+  // every start vertex begins at the length of its virtual edge:
+  //
+  for (const pair<VertexT, double>& start : starts)
+  {
+    int index = G.indexOf(start.first);
+
+    if (index >= 0 && state.relax(index, start.second, -1))
+      unvisitedQueue.push(index, start.second);
+  }
+
+  for (const pair<VertexT, double>& target : targets)
+  {
+    targetIndices.push_back(G.indexOf(target.first));
+  }
+
+  //
+  // nothing settled from here on can lead to a shorter way to the end:
+  //
+  DijkstraSettle(G, state, unvisitedQueue,
+    [&](int index, double distance)
+    {
+      if (distance >= best)
+        return true;
+
+      for (size_t j = 0; j < targets.size(); j++)
+      {
+        if (targetIndices[j] == index)
+          best = min(best, distance + targets[j].second);
+      }
+
+      return false;
+    });
+
+  //
+  // best way off the graph to the virtual end.  A target left in the
+  // queue with a tentative distance still has a real path behind it:
+  //
+  int  bestIndex = -1;
+
+  best = INF;
+
+  for (size_t j = 0; j < targets.size(); j++)
+  {
+    int index = targetIndices[j];
+
+    if (index >= 0 && state.distance(index) + targets[j].second < best)
+    {
+      best = state.distance(index) + targets[j].second;
+      bestIndex = index;
+    }
+  }
+
+  if (bestIndex == -1)  // unreachable:
+    return INF;
+
+  for (int index = bestIndex; index != -1; index = state.predecessor(index))
+  {
+    path.push_back(G.vertexAt(index));
+  }
+
+  reverse(path.begin(), path.end());
+
+  return best;
+}
+
+template<typename VertexT>
+double DijkstraSeededPath(const csrgraph<VertexT, double>& G,
+  const vector<pair<VertexT, double>>& starts,
+  const vector<pair<VertexT, double>>& targets,
+  vector<VertexT>& path,
+  SearchWorkspace& state)
+{
+  BinaryHeapQueue  queue(state.heap());
+
+  return DijkstraSeededPath(G, starts, targets, path, state, queue);
+}
+
+
+//
+// PathDistance:
+//
+// Adds up the edge weights along a path of indices, from the first
+// vertex to the last, the same order Dijkstra accumulates them in.
+// Searches that build their distance some other way (e.g. from both
+// ends) use this so they report exactly what DijkstraPath would.  A NaN
+// weight (see FixedPointWeights::toUnits) counts as 0.
+//
+template<typename VertexT>
+double PathDistance(const csrgraph<VertexT, double>& G,
+  const vector<int>& indices)
+{
+  double total = 0;
+
+  for (size_t i = 0; i + 1 < indices.size(); i++)
+  {
+    double weight = INF;
+
+    for (int e = G.edgesBegin(indices[i]); e < G.edgesEnd(indices[i]); e++)
+    {
+      if (G.edgeTarget(e) == indices[i + 1])
+      {
+        weight = G.edgeWeight(e);
+        break;
+      }
+    }
+
+    if (weight == INF)  // not a path in G:
+      return INF;
+
+    if (!isnan(weight))  // acos can give NaN for two nodes at the same spot
+      total += weight;
+  }
+
+  return total;
+}
+
+
+//
+// BidirectionalDijkstraPath:
+//
+// Point-to-point search that grows one Dijkstra forward from startV
+// over G and one backward from destV over reverseG (the transpose of
+// G, see csrgraph::reversed; for a symmetric graph such as the footway
+// graph, G itself).  Each step expands the side whose queue has the
+// smaller minimum.  mu is the shortest start->dest path seen so far
+// through a vertex reached by both sides, and the search stops once
+// the two queue minimums add up to at least mu, since no unexplored
+// path can be shorter.  The path is stitched together at the meeting
+// vertex.
+//
+// Returns the distance and fills path exactly like DijkstraPath.
+// forward and backward are the caller's reusable workspaces.
+//
+template<typename VertexT>
+double BidirectionalDijkstraPath(const csrgraph<VertexT, double>& G,
+  const csrgraph<VertexT, double>& reverseG,
+  VertexT startV,
+  VertexT destV,
+  vector<VertexT>& path,
+  SearchWorkspace& forward,
+  SearchWorkspace& backward)
+{
+  prioritizeIndex  prioritize;
+  int startIndex = G.indexOf(startV);
+  int destIndex = G.indexOf(destV);
+
+  path.clear();
+
+  if (startIndex < 0 || destIndex < 0)
+    return INF;
+
+  forward.reset(G.NumVertices());
+  backward.reset(G.NumVertices());
+
+  vector<pair<int,double>>& forwardQueue = forward.heap();
+  vector<pair<int,double>>& backwardQueue = backward.heap();
+
+  forward.update(startIndex, 0, -1);
+  forwardQueue.push_back(make_pair(startIndex, 0));
+  backward.update(destIndex, 0, -1);
+  backwardQueue.push_back(make_pair(destIndex, 0));
+
+  double mu = (startIndex == destIndex) ? 0 : INF;  // best path so far
+  int    meeting = (startIndex == destIndex) ? startIndex : -1;
+
+  while (!forwardQueue.empty() && !backwardQueue.empty())
+  {
+    //
+    // heap fronts are the minimums (possibly stale, which only
+    // makes this check more conservative):
+    //
+    if (forwardQueue.front().second + backwardQueue.front().second >= mu)
+      break;
+
+    //
+    // expand the side with the smaller minimum (forward on ties):
+    //
+    bool isForward = forwardQueue.front().second <= backwardQueue.front().second;
+
+    const csrgraph<VertexT, double>& side = isForward ? G : reverseG;
+    SearchWorkspace& state = isForward ? forward : backward;
+    SearchWorkspace& other = isForward ? backward : forward;
+    vector<pair<int,double>>& queue = state.heap();
+
+    pop_heap(queue.begin(), queue.end(), prioritize);
+    auto kvpair = queue.back();
+    queue.pop_back();
+
+    int currV = kvpair.first;
+
+    if (state.settled(currV))  // already visited?
+      continue;
+
+    state.settle(currV);
+
+    double currDist = kvpair.second;
+
+    for (int e = side.edgesBegin(currV); e < side.edgesEnd(currV); e++)
+    {
+      int adjV = side.edgeTarget(e);
+
+      if (state.relax(adjV, currDist + side.edgeWeight(e), currV))
+      {
+        queue.push_back(make_pair(adjV, state.distance(adjV)));
+        push_heap(queue.begin(), queue.end(), prioritize);
+      }
+
+      //
+      // has the other side reached adjV too?  Then there is a
+      // start->dest path through it:
+      //
+      double otherDist = other.distance(adjV);
+
+      if (otherDist != INF && state.distance(adjV) + otherDist < mu)
+      {
+        mu = state.distance(adjV) + otherDist;
+        meeting = adjV;
+      }
+    }
+  }//while
+
+  if (meeting == -1)  // unreachable:
+    return INF;
+
+  //
+  // stitch: start..meeting from the forward predecessors, then
+  // meeting..dest from the backward ones (which point toward dest):
+  //
+  vector<int> indices;
+
+  for (int index = meeting; index != -1; index = forward.predecessor(index))
+  {
+    indices.push_back(index);
+  }
+
+  reverse(indices.begin(), indices.end());
+
+  for (int index = backward.predecessor(meeting); index != -1; index = backward.predecessor(index))
+  {
+    indices.push_back(index);
+  }
+
+  for (int index : indices)
+  {
+    path.push_back(G.vertexAt(index));
+  }
+
+  return PathDistance(G, indices);
+}
+
+
+//
+// AStarPath:
+//
+// Point-to-point search guided toward destV by heuristic (see
+// heuristics.h), which is bound to destV and returns a lower bound on
+// the distance from an index to destV.  Vertices come off the queue in
+// order of distance-so-far plus heuristic, so the search heads toward
+// the destination instead of growing a circle around the start.
+//
+// A vertex whose distance improves after it was settled is put back on
+// the queue.  With an exact, consistent heuristic that never happens;
+// it makes the result exact even when floating point rounding makes
+// the heuristic very slightly inconsistent.
+//
+// Returns the distance and fills path exactly like DijkstraPath.  state
+// is the caller's reusable workspace.
+//
+template<typename VertexT, typename HeuristicT>
+double AStarPath(const csrgraph<VertexT, double>& G,
+  VertexT startV,
+  VertexT destV,
+  const HeuristicT& heuristic,
+  vector<VertexT>& path,
+  SearchWorkspace& state)
+{
+  prioritizeIndex  prioritize;
+  int startIndex = G.indexOf(startV);
+  int destIndex = G.indexOf(destV);
+
+  path.clear();
+
+  if (startIndex < 0 || destIndex < 0)
+    return INF;
+
+  state.reset(G.NumVertices());
+
+  //
+  // queue entries are (index, distance so far + heuristic):
+  //
+  vector<pair<int,double>>& unvisitedQueue = state.heap();
+
+  state.update(startIndex, 0, -1);
+  unvisitedQueue.push_back(make_pair(startIndex, heuristic(startIndex)));
+
+  while (!unvisitedQueue.empty())
+  {
+    pop_heap(unvisitedQueue.begin(), unvisitedQueue.end(), prioritize);
+    int currV = unvisitedQueue.back().first;
+    unvisitedQueue.pop_back();
+
+    if (state.settled(currV))  // stale entry:
+      continue;
+
+    state.settle(currV);
+
+    if (currV == destIndex)
+      break;
+
+    double currDist = state.distance(currV);
+
+    for (int e = G.edgesBegin(currV); e < G.edgesEnd(currV); e++)
+    {
+      int adjV = G.edgeTarget(e);
+      double altDist = currDist + G.edgeWeight(e);
+
+      if (state.relax(adjV, altDist, currV))
+      {
+        state.unsettle(adjV);  // reopen if it was already settled
+        unvisitedQueue.push_back(make_pair(adjV, altDist + heuristic(adjV)));
+        push_heap(unvisitedQueue.begin(), unvisitedQueue.end(), prioritize);
+      }
+    }
+  }//while
+
+  if (!state.settled(destIndex))  // unreachable:
+    return INF;
+
+  for (int index = destIndex; index != -1; index = state.predecessor(index))
+  {
+    path.push_back(G.vertexAt(index));
+  }
+
+  reverse(path.begin(), path.end());
+
+  return state.distance(destIndex);
+}
@@ -0,0 +1,473 @@
+// alt.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// ALT = A* + Landmarks + Triangle inequality.
+//
+// A handful of landmark vertices are picked ahead of time and the distance
+// from every vertex to and from each landmark is stored.  For a landmark L
+// the triangle inequality gives two lower bounds on d(v, t):
+//
+//    d(v, t) >= d(L, t) - d(L, v)
+//    d(v, t) >= d(v, L) - d(t, L)
+//
+// ALTHeuristic takes the best of these over the landmarks and is used
+// with AStarPath (see algs.h).  Unlike the straight-line bound it follows
+// the footways, so it stays tight around rivers, expressways and fences.
+//
+// Example:
+//    ALTLandmarks<uint32_t> landmarks;
+//    if (!landmarks.load("map.osm.landmarks", CG)) {
+//        landmarks.build(CG, CG, 8);
+//        landmarks.save("map.osm.landmarks");
+//    }
+//    ALTHeuristic<uint32_t> heuristic(landmarks, CG, startV, destV);
+//    AStarPath(CG, startV, destV, heuristic, path, workspace);
+//
+
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+#include "csrgraph.h"
+#include "algs.h"
+#include "scheduler.h"
+
+using namespace std;
+
+template<typename VertexT>
+class ALTLandmarks {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	int nVertices;
+	uint64_t Fingerprint;    // GraphFingerprint() of the graph it was built on
+	vector<int> Landmarks;   // Landmark indices
+
+	// Most landmarks build() picks; more only adds memory, not speed
+	static const int MaxLandmarks = 64;
+
+	//
+	// Distance tables, one row of nVertices floats per landmark:
+	//   FromLandmark[k * nVertices + v] = d(Landmarks[k], v)
+	//   ToLandmark[k * nVertices + v]   = d(v, Landmarks[k])
+	// For a symmetric graph the two are the same, so ToLandmark is left
+	// empty and FromLandmark is used for both.  Unreachable is +infinity.
+	//
+	vector<float> FromLandmark;
+	vector<float> ToLandmark;
+
+	//
+	// fillRow
+	//
+	// Runs Dijkstra from landmark over G and copies the distances into
+	// row k of table.
+	//
+	static void fillRow(const csrgraph<VertexT, double> &G, int landmark,
+	int k, vector<float> &table, SearchWorkspace &workspace) {
+		vector<double> distances;
+		vector<int> predecessors;
+
+		Dijkstra(G, G.vertexAt(landmark), distances, predecessors, workspace);
+
+		for (int v = 0; v < G.NumVertices(); v++) {
+			table[(size_t) k * G.NumVertices() + v] = (distances[v] == INF) ?
+				numeric_limits<float>::infinity() : (float) distances[v];
+		}
+	}
+
+	//
+	// largestComponent
+	//
+	// Returns the vertices of the largest weakly connected component of
+	// G, found with union-find over the edges.  Landmarks are only
+	// picked there; isolated building nodes and small disconnected
+	// footways would be wasted landmarks.
+	//
+	static vector<int> largestComponent(const csrgraph<VertexT, double> &G) {
+		vector<int> parent(G.NumVertices());
+
+		for (int v = 0; v < G.NumVertices(); v++) {
+			parent[v] = v;
+		}
+
+		// Find with path halving
+		auto find = [&parent](int v) {
+			while (parent[v] != v) {
+				parent[v] = parent[parent[v]];
+				v = parent[v];
+			}
+			return v;
+		};
+
+		for (int v = 0; v < G.NumVertices(); v++) {
+			for (int e = G.edgesBegin(v); e < G.edgesEnd(v); e++) {
+				parent[find(v)] = find(G.edgeTarget(e));
+			}
+		}
+
+		vector<int> size(G.NumVertices(), 0);
+		int largest = 0;
+
+		for (int v = 0; v < G.NumVertices(); v++) {
+			int root = find(v);
+
+			size[root]++;
+			if (size[root] > size[largest]) {
+				largest = root;
+			}
+		}
+
+		vector<int> component;  // Return Value
+
+		for (int v = 0; v < G.NumVertices(); v++) {
+			if (find(v) == largest) {
+				component.push_back(v);
+			}
+		}
+
+		return component;
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	ALTLandmarks() {
+		nVertices = 0;
+		Fingerprint = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// build
+	//
+	// Picks up to numLandmarks (at most MaxLandmarks) landmarks with the
+	// "farthest" strategy and precomputes their distance tables.
+	// reverseG is the transpose of G (csrgraph::reversed); pass G itself
+	// for a symmetric graph such as the footway graph, which halves the
+	// tables.
+	//
+	// Farthest: the first landmark is the vertex farthest from an
+	// arbitrary start vertex, and each next one is the vertex whose
+	// distance to the nearest landmark chosen so far is the largest.
+	// This spreads landmarks around the edge of the map, where their
+	// bounds are tightest.
+	//
+	// Each pick depends on the rows before it, so the forward rows are
+	// computed one at a time.  The backward rows of a directed graph are
+	// independent and run in parallel on scheduler, if one is given.
+	//
+	void build(const csrgraph<VertexT, double> &G,
+	const csrgraph<VertexT, double> &reverseG, int numLandmarks,
+	WorkStealingScheduler *scheduler = nullptr) {
+		bool symmetric = (&G == &reverseG);
+		vector<int> component = largestComponent(G);
+		SearchWorkspace workspace;
+
+		nVertices = G.NumVertices();
+		Fingerprint = GraphFingerprint(G);
+		Landmarks.clear();
+		FromLandmark.clear();
+		ToLandmark.clear();
+
+		if (nVertices == 0) {
+			return;
+		}
+
+		numLandmarks = min(min(numLandmarks, (int) MaxLandmarks), (int) component.size());
+
+		// Room for the extra row used to find the first landmark
+		FromLandmark.resize((size_t) (numLandmarks + 1) * nVertices);
+
+		//////////////////////////////////////////////////////////////
+		// Pick landmarks, filling in each one's row as we go along //
+		//////////////////////////////////////////////////////////////
+
+		// closest[v] = distance from v to its nearest landmark so far
+		vector<float> closest(nVertices, numeric_limits<float>::infinity());
+		int next = component[0];
+
+		fillRow(G, next, numLandmarks, FromLandmark, workspace);
+
+		for (int k = 0; k < numLandmarks; k++) {
+			//
+			// Choose the component vertex farthest from the landmarks so
+			// far (from the arbitrary start vertex, the first time)
+			//
+			const float *row = &FromLandmark[(size_t) (k == 0 ? numLandmarks : k - 1) * nVertices];
+			float farthest = -1;
+
+			for (int v : component) {
+				if (k > 0) {
+					closest[v] = min(closest[v], row[v]);
+				}
+
+				float candidate = (k == 0) ? row[v] : closest[v];
+
+				if (candidate != numeric_limits<float>::infinity() && candidate > farthest) {
+					farthest = candidate;
+					next = v;
+				}
+			}
+
+			Landmarks.push_back(next);
+			fillRow(G, next, k, FromLandmark, workspace);
+		}
+
+		FromLandmark.resize((size_t) numLandmarks * nVertices);
+
+		if (!symmetric) {
+			ToLandmark.resize(FromLandmark.size());
+
+			if (scheduler != nullptr) {
+				// One workspace per worker; each task fills its own row
+				vector<SearchWorkspace> workspaces(scheduler->NumWorkers());
+
+				scheduler->parallelFor(numLandmarks, [&](size_t k, int worker) {
+					fillRow(reverseG, Landmarks[k], (int) k, ToLandmark, workspaces[worker]);
+				});
+			} else {
+				for (int k = 0; k < numLandmarks; k++) {
+					fillRow(reverseG, Landmarks[k], k, ToLandmark, workspace);
+				}
+			}
+		}
+	}
+
+	//
+	// NumLandmarks
+	//
+	int NumLandmarks() const {
+		return (int) Landmarks.size();
+	}
+
+	//
+	// getLandmarks
+	//
+	// Returns the landmark indices.
+	//
+	const vector<int>& getLandmarks() const {
+		return Landmarks;
+	}
+
+	//
+	// fromLandmark / toLandmark
+	//
+	// d(landmark k, index) and d(index, landmark k); +infinity if there
+	// is no such path.
+	//
+	float fromLandmark(int k, int index) const {
+		return FromLandmark[(size_t) k * nVertices + index];
+	}
+
+	float toLandmark(int k, int index) const {
+		const vector<float> &table = ToLandmark.empty() ? FromLandmark : ToLandmark;
+
+		return table[(size_t) k * nVertices + index];
+	}
+
+	//
+	// matches
+	//
+	// Returns true if these tables were built on graph G.
+	//
+	bool matches(const csrgraph<VertexT, double> &G) const {
+		return nVertices == G.NumVertices() && Fingerprint == GraphFingerprint(G);
+	}
+
+	//
+	// save
+	//
+	// Writes the landmarks and tables to a binary file, returning false
+	// if the file cannot be written.  By convention the file sits next to
+	// the map, e.g. "map.osm.landmarks".
+	//
+	bool save(const string &filename) const {
+		ofstream file(filename, ios::binary);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		int32_t header[3] = { nVertices, NumLandmarks(), ToLandmark.empty() ? 1 : 0 };
+
+		file.write("ALT1", 4);
+		file.write((const char *) &Fingerprint, sizeof(Fingerprint));
+		file.write((const char *) header, sizeof(header));
+		file.write((const char *) Landmarks.data(), Landmarks.size() * sizeof(int));
+		file.write((const char *) FromLandmark.data(), FromLandmark.size() * sizeof(float));
+		file.write((const char *) ToLandmark.data(), ToLandmark.size() * sizeof(float));
+
+		return file.good();
+	}
+
+	//
+	// load
+	//
+	// Reads tables written by save().  Returns false, leaving this object
+	// unchanged, if the file is missing, unreadable, corrupt, or was built
+	// on a different graph than G.
+	//
+	bool load(const string &filename, const csrgraph<VertexT, double> &G) {
+		ifstream file(filename, ios::binary);
+		char magic[4];
+		uint64_t fingerprint;
+		int32_t header[3];
+
+		if (!file.read(magic, 4) || memcmp(magic, "ALT1", 4) != 0 ||
+		!file.read((char *) &fingerprint, sizeof(fingerprint)) ||
+		!file.read((char *) header, sizeof(header))) {
+			return false;
+		}
+
+		// Sizes are checked before anything is allocated from them
+		if (header[0] != G.NumVertices() || header[1] < 0 ||
+		header[1] > MaxLandmarks || header[1] > header[0] ||
+		(header[2] != 0 && header[2] != 1) ||
+		fingerprint != GraphFingerprint(G)) {
+			return false;
+		}
+
+		size_t tableSize = (size_t) header[1] * header[0];
+		vector<int> landmarks(header[1]);
+		vector<float> fromLandmark(tableSize);
+		vector<float> toLandmark(header[2] ? 0 : tableSize);
+
+		if (!file.read((char *) landmarks.data(), landmarks.size() * sizeof(int)) ||
+		!file.read((char *) fromLandmark.data(), fromLandmark.size() * sizeof(float)) ||
+		!file.read((char *) toLandmark.data(), toLandmark.size() * sizeof(float))) {
+			return false;
+		}
+
+		for (int landmark : landmarks) {
+			if (landmark < 0 || landmark >= header[0]) {
+				return false;
+			}
+		}
+
+		nVertices = header[0];
+		Fingerprint = fingerprint;
+		Landmarks.swap(landmarks);
+		FromLandmark.swap(fromLandmark);
+		ToLandmark.swap(toLandmark);
+
+		return true;
+	}
+};
+
+//
+// ALTHeuristic
+//
+// Landmark lower bound on the distance from an index to one destination,
+// for AStarPath.  Only the few landmarks that give the best bound between
+// start and destination are consulted on each call.
+//
+template<typename VertexT>
+class ALTHeuristic {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	const ALTLandmarks<VertexT> *Landmarks;
+	int DestIndex;
+	vector<int> Active;  // Landmarks consulted, best first
+
+	public:
+	//
+	// MaxActive
+	//
+	// # of landmarks consulted per query.  More gives a tighter bound but
+	// costs more per call.
+	//
+	static const int MaxActive = 4;
+
+	//
+	// RelativeSlack
+	//
+	// Tables are stored as floats, which round each distance by up to one
+	// part in 2^24.  Taking this fraction of the two distances off each
+	// bound keeps it a lower bound after rounding.
+	//
+	static constexpr double RelativeSlack = 1.2e-7;
+
+	ALTHeuristic(const ALTLandmarks<VertexT> &landmarks,
+	const csrgraph<VertexT, double> &G, VertexT startV, VertexT destV) {
+		this->Landmarks = &landmarks;
+		this->DestIndex = G.indexOf(destV);
+
+		int startIndex = G.indexOf(startV);
+
+		if (startIndex < 0 || DestIndex < 0) {
+			return;
+		}
+
+		// Rank landmarks by the bound each gives for startV
+		vector<pair<double, int>> ranked;
+
+		for (int k = 0; k < landmarks.NumLandmarks(); k++) {
+			ranked.push_back(make_pair(bound(k, startIndex), k));
+		}
+
+		sort(ranked.rbegin(), ranked.rend());
+
+		for (int i = 0; i < (int) ranked.size() && i < MaxActive; i++) {
+			Active.push_back(ranked[i].second);
+		}
+	}
+
+	//
+	// bound
+	//
+	// Lower bound on d(index, destination) from landmark k alone.
+	//
+	double bound(int k, int index) const {
+		double best = 0;
+
+		double fromDest = Landmarks->fromLandmark(k, DestIndex);
+		double fromCurr = Landmarks->fromLandmark(k, index);
+
+		// d(v, t) >= d(L, t) - d(L, v)
+		if (fromDest != INFINITY && fromCurr != INFINITY) {
+			best = max(best, fromDest - fromCurr - RelativeSlack * (fromDest + fromCurr));
+		}
+
+		double toCurr = Landmarks->toLandmark(k, index);
+		double toDest = Landmarks->toLandmark(k, DestIndex);
+
+		// d(v, t) >= d(v, L) - d(t, L)
+		if (toCurr != INFINITY && toDest != INFINITY) {
+			best = max(best, toCurr - toDest - RelativeSlack * (toCurr + toDest));
+		}
+
+		return best;
+	}
+
+	double operator()(int index) const {
+		double best = 0;
+
+		for (int k : Active) {
+			best = max(best, bound(k, index));
+		}
+
+		return best;
+	}
+};
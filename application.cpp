@@ -17,24 +17,40 @@
 //
 #include <iostream>
 #include <iomanip>		// setprecision
-#include <limits>		// For INF definition
 #include <string>
 #include <vector>
-#include <stack>
-#include <queue>
 #include <map>
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
 #include <cassert>
 #include "tinyxml2.h"
 #include "graph.h"
+#include "csrgraph.h"
+#include "algs.h"
+#include "router.h"
+#include "batch.h"
+#include "matrix.h"
+#include "routecache.h"
+#include "kdtree.h"
+#include "grid.h"
+#include "rtree.h"
+#include "metrics.h"
+#include "idmap.h"
+#include "footwaygraph.h"
 #include "dist.h"
 #include "osm.h"
 
 using namespace std;
 using namespace tinyxml2;
 
-#define INF (numeric_limits<double>::max())
+// # of building pairs whose routes the interactive loop remembers
+const int RouteCacheCapacity = 64;
+
+// Index that finds the footway node nearest to a building: FootwayGrid
+// (grid.h, almost free to build) or FootwayKdTree (kdtree.h).  Both give
+// the same answers.
+typedef FootwayGrid FootwayIndex;
 
 // checkForMatch
 //
@@ -68,192 +84,327 @@ string &buildingFullName, Coordinates &buildingCoordinates) {
 	}
 }
 
-// Prioritize functor
-// Gives the priority queue instructions on how to prioritize the incoming pairs
-class prioritize {
-	public:
-	bool operator()(const pair<long long, double> &p1,
-					const pair<long long, double> &p2) const {
-		if (p1.second > p2.second) {
-			return true;
-		} else if (p1.second < p2.second) {
-			return false;
-		} else {  // If distances are equal, sort by ID instead
-			return p1.first > p2.first;
+//
+// findStartAndDest
+//
+// Looks up the footway nodes closest to the start and destination
+// buildings in the footway index (see FootwayIndex).
+//
+void findStartAndDest(const Coordinates &startBuilding,
+                      const Coordinates &destBuilding,
+                      Coordinates &startCoords,
+                      Coordinates &destCoords,
+                      const FootwayIndex &footwayIndex,
+                      const vector<Coordinates> &NodeCoords) {
+	// Indices of closest footway nodes to the start and destination buildings
+	uint32_t startIndex = footwayIndex.nearest(startBuilding);
+	uint32_t destIndex = footwayIndex.nearest(destBuilding);
+
+	/////////////////////////////////////////////////
+	// Return closest coordinates to each building //
+	/////////////////////////////////////////////////
+
+	startCoords = NodeCoords.at(startIndex);
+	destCoords = NodeCoords.at(destIndex);
+}
+
+//
+// Trip
+//
+// One start/destination query after the buildings and the nearest
+// footway nodes have been looked up, see planTrip.
+//
+struct Trip {
+	// Indicates if start and destinations were found
+	bool startFound;
+	bool destFound;
+
+	// Positions of the buildings in the building list, -1 if not found
+	int startBuilding;
+	int destBuilding;
+
+	// Saves building names if found
+	string startBuildingFullName;
+	string destBuildingFullName;
+
+	Coordinates startBuildingCoordinates;
+	Coordinates destBuildingCoordinates;
+
+	// Closest footway nodes, only set if both buildings were found
+	Coordinates startPointCoords;
+	Coordinates destPointCoords;
+
+	// With --segments: closest points on the footways instead
+	bool snapped;
+	SegmentSnap startSnap;
+	SegmentSnap destSnap;
+};
+
+//
+// findBuildings
+//
+// Looks up the start and destination buildings for the user's queries.
+// The nearest footway nodes are left for findStartAndDest.
+//
+Trip findBuildings(const string &startQuery, const string &destQuery,
+const vector<BuildingInfo> &Buildings) {
+	Trip trip;
+
+	trip.startFound = false;
+	trip.destFound = false;
+	trip.startBuilding = -1;
+	trip.destBuilding = -1;
+	trip.snapped = false;
+
+	///////////////////////////////////////////////////////////////
+	// Search the building vector for the user inputted name.    //
+	// Checks abbreviation, if no match, the finds partial name. //
+	///////////////////////////////////////////////////////////////
+
+	for (int i = 0; i < (int) Buildings.size(); i++) {
+		const BuildingInfo &currBuilding = Buildings[i];
+
+		// Base Case: Start and Destination Buildings are Valid
+		if (trip.startFound && trip.destFound) {
+			break;
+		}
+
+		// Check if the current building matches the start building query
+		if (!trip.startFound) {
+			trip.startFound = checkForMatch(currBuilding, startQuery,
+			trip.startBuildingFullName, trip.startBuildingCoordinates);
+			trip.startBuilding = trip.startFound ? i : -1;
+		}
+
+		// Check if the current building matches the dest building query
+		if (!trip.destFound) {
+			trip.destFound = checkForMatch(currBuilding, destQuery,
+			trip.destBuildingFullName, trip.destBuildingCoordinates);
+			trip.destBuilding = trip.destFound ? i : -1;
 		}
 	}
-};
 
-// Dijkstra's Algorithm w/ Shortest Path Implementation
-vector<long long> Dijkstra(
-	const graph<long long, double>& G,       // Graph of node IDs and Distances
-	const long long startV,				     // Start vertexID
-	map<long long, double>& distances, 	     // <vertexID, shortest distance from startV and current vertex>
-	map<long long, long long>& predecessors  // <VertexID, Closest Prev Neighbor>
-) {
-	// Return Value: IDs of all visited verticies during runtime of algoritm
-	vector<long long>  visited;
-
-	// Keeps track of the verticies that the Dijkstra's will visit
-	priority_queue<pair<long long, double>,
-				   vector<pair<long long, double>>,
-				   prioritize> unvisitedQueue;
-
-	// Keeps track of visited vertex IDs so none are revisited
-	set<long long> visitedSet;
-
-	//////////////////////////////////////////////////////////////////////////
-	// Fill unvisited queue with all verticies from graph with distance INF //
-	//////////////////////////////////////////////////////////////////////////
-
-	for (auto currVertex : G.getVertices()) {
-		unvisitedQueue.push(make_pair(currVertex, INF));
-		distances[currVertex] = INF;  // Main loop termination requirement
-		predecessors[currVertex] = -1;
+	return trip;
+}
+
+//
+// locateTrip
+//
+// Once both buildings are found, finds where they join the footways:
+// the closest footway nodes, or with footwaySegments the closest points
+// on any footway segment.
+//
+void locateTrip(Trip &trip, const FootwayIndex &footwayIndex,
+const FootwayRTree *footwaySegments, const vector<Coordinates> &NodeCoords) {
+	if (!trip.startFound || !trip.destFound) {
+		return;
 	}
 
-	// Add start vertex to distance map
-	distances[startV] = 0;
-	// Distance from start vertex to itself is 0
-	unvisitedQueue.push(make_pair(startV, 0));
-
-	// For each unvisited node in the graph
-	//		Calculate the distance between the currentV and startV
-	//			If a shorter path was found, update the distance
-
-	// For each node in the unvisited queue
-	// NOTE: !unvisitedQueue.empty() condition almost never met
-	while (!unvisitedQueue.empty()) {
-		////////////////////////////////////////////////
-		// Pop the first node from the priority queue //
-		////////////////////////////////////////////////
-
-		long long currentV = unvisitedQueue.top().first;
-		unvisitedQueue.pop();
-
-		///////////////////////////////////////////////////////////////////
-		// while loop depends on current vertex from the unvisited queue //
-		///////////////////////////////////////////////////////////////////
-
-		// Base case: All vertices visited, rest of queue has INF distance
-		if (distances[currentV] == INF) {
-			break;  // Rest of the nodes in unvisitedQueue have INF distance
-		} else if (visitedSet.count(currentV) != 0) {  // Visited previously
-			continue;  // Skip
-		} else {  // Vertex has not been visited yet
-			visitedSet.insert(currentV);  // Prevents revisting of node
-			visited.push_back(currentV);  // Adds to return value
-		}
+	if (footwaySegments != nullptr) {
+		trip.snapped = true;
+		footwaySegments->nearest(trip.startBuildingCoordinates, trip.startSnap);
+		footwaySegments->nearest(trip.destBuildingCoordinates, trip.destSnap);
+	} else {
+		findStartAndDest(trip.startBuildingCoordinates, trip.destBuildingCoordinates,
+		trip.startPointCoords, trip.destPointCoords, footwayIndex, NodeCoords);
+	}
+}
 
-		////////////////////////////////////////////////////////
-		// Update distance and path if shorter path was found //
-		////////////////////////////////////////////////////////
+//
+// planTrip
+//
+// Looks up the start and destination buildings for the user's queries
+// and, if both are found, where they join the footways (see locateTrip).
+//
+Trip planTrip(const string &startQuery, const string &destQuery,
+const vector<BuildingInfo> &Buildings, const FootwayIndex &footwayIndex,
+const FootwayRTree *footwaySegments, const vector<Coordinates> &NodeCoords) {
+	Trip trip = findBuildings(startQuery, destQuery, Buildings);
 
-		// For each neighbor of the current vertex
-		for (auto currNeighbor : G.neighbors(currentV)) {
-			double distance;     // Current closest distance found between
-								 // startV and currNeighbor
+	locateTrip(trip, footwayIndex, footwaySegments, NodeCoords);
 
-			double altDistance;  // Distance between startV and currNeighbor
+	return trip;
+}
 
-			// Grab distance between currentV and it's current neighbor
-			G.getWeight(currentV, currNeighbor, distance);
-			altDistance = distances.at(currentV) + distance;
+//
+// printTrip
+//
+// Prints what planTrip found, up to the point where the route is
+// computed (see printRoute).
+//
+void printTrip(const Trip &trip) {
+	////////////////////////////////////////////////////////
+	// Case: Start and/or Destination Point was not Found //
+	////////////////////////////////////////////////////////
 
-			// Update if a shorter path from startV to currNeighbor is found
-			if (altDistance < distances[currNeighbor]) {
-				distances[currNeighbor] = altDistance;
-				unvisitedQueue.push(make_pair(currNeighbor, altDistance));
-				predecessors[currNeighbor] = currentV;
-			}
+	if (!trip.startFound) {
+		cout << "Start building not found" << endl;
+	} else {
+		if (!trip.destFound) {
+			cout << "Destination building not found" << endl;
 		}
 	}
 
-	return visited;  // Return all nodes visited
+	if (!trip.startFound || !trip.destFound) {
+		return;
+	}
+
+	////////////////////
+	// Output Results //
+	////////////////////
+
+	// Print Start Building Point
+	cout << "Starting point:" << endl;
+	cout << " " << trip.startBuildingFullName << endl;
+	cout << " (" << trip.startBuildingCoordinates.Lat << ", "
+	<< trip.startBuildingCoordinates.Lon << ")" << endl;;
+
+	// Print Destination Building Point
+	cout << "Destination point:" << endl;
+	cout << " " << trip.destBuildingFullName << endl;
+	cout << " (" << trip.destBuildingCoordinates.Lat << ", "
+	<< trip.destBuildingCoordinates.Lon << ")" << endl;
+
+	cout << endl;
+
+	if (trip.snapped) {
+		// Print Nearest Footway Points to Both Buildings
+		cout << "Nearest start point:" << endl;
+		cout << " on footway " << trip.startSnap.FootwayID << endl;
+		cout << " (" << trip.startSnap.Lat << ", " << trip.startSnap.Lon << ")" << endl;
+
+		cout << "Nearest destination point:" << endl;
+		cout << " on footway " << trip.destSnap.FootwayID << endl;
+		cout << " (" << trip.destSnap.Lat << ", " << trip.destSnap.Lon << ")" << endl;
+
+		cout << endl;
+
+		cout << "Navigating with Dijkstra..." << endl;
+		return;
+	}
+
+	// Print Nearest Footway Node to Start Building
+	cout << "Nearest start node:" << endl;
+	cout << " " << trip.startPointCoords.ID << endl;
+	cout << " (" << trip.startPointCoords.Lat << ", "
+	<< trip.startPointCoords.Lon << ")";
+	cout << endl;
+
+	// Print Nearest Footway Node to Destination Building
+	cout << "Nearest destination node:" << endl;
+	cout << " " << trip.destPointCoords.ID << endl;
+	cout << " (" << trip.destPointCoords.Lat << ", "
+	<< trip.destPointCoords.Lon << ")";
+	cout << endl;
+
+	cout << endl;
+
+	cout << "Navigating with Dijkstra..." << endl;
 }
 
 //
-// findStartAndDest
+// printRoute
 //
-// Looks at all footway nodes and compares distances
-// Will return the two nodes closest to the start and end
-// destinations 
+// Prints the distance and the footway nodes of a route found by the
+// router, translating the node indices back to OSM node IDs.  A route
+// between snapped points (see locateTrip) begins and ends off the nodes,
+// which is shown as (start) and (dest).
 //
-void findStartAndDest(const Coordinates &startBuilding,
-                      const Coordinates &destBuilding,
-                      Coordinates &startCoords,
-                      Coordinates &destCoords,
-                      const vector<FootwayInfo> &Footways,
-                      const map<long long, Coordinates> &mapNodes) {
-	// IDs of closest footway nodes to the start and destination buildings
-	// The ID is looked up looked up at the very last step.
-	long long destID;
-	long long startID;
-
-	// Save lat and lon coordinates for start building
-	double startBuildingLat = startBuilding.Lat;
-	double startBuildingLon = startBuilding.Lon;
-
-	// Save lat and lon coordinates for dest building
-	double destBuildingLat = destBuilding.Lat;
-	double destBuildingLon = destBuilding.Lon;
-
-	// Initialize closest distances
-	double closestStartDistance = INF;
-	double closestDestDistance = INF;
-
-	////////////////////////////////////////////////////////////
-	// Search for the closest footway node for both buildings //
-	////////////////////////////////////////////////////////////
-
-	// For each footway
-	for (auto currFootway : Footways) {
-		// For each node in the footway
-		for (int i = 0; i < (int)currFootway.Nodes.size(); i++) {
-			// Look up the current footway node in the Nodes map
-			Coordinates currCoordinates = mapNodes.at(currFootway.Nodes[i]);
-			double currLat = currCoordinates.Lat;
-			double currLon = currCoordinates.Lon;
-
-			///////////////////////////////////////////////////////////////////
-			// Calculate distance between buildings and current footway node //
-			///////////////////////////////////////////////////////////////////
-
-			// Distance between start building and current footway node
-			double currentStartDistance = distBetween2Points(startBuildingLat,
-			startBuildingLon, currLat, currLon);
-
-			// Distance between destination building and current footway node
-			double currentDestDistance = distBetween2Points(destBuildingLat,
-			destBuildingLon, currLat, currLon);
-
-			/////////////////////////////////////////////////////////
-			// If a shorter distance was found, update closest IDs //
-			/////////////////////////////////////////////////////////
-
-			// Closer footway node to start building found
-			if (currentStartDistance < closestStartDistance) {
-				closestStartDistance = currentStartDistance;
-				startID = currCoordinates.ID;
-			}
+void printRoute(double travelDistance, const vector<uint32_t> &path,
+const IDMapper &mapper, bool snapped = false) {
+	///////////////////////////////////////////////////
+	// Output Reachability of Destination from Start //
+	///////////////////////////////////////////////////
+
+	if (travelDistance != INF) {
+		cout << "Distance to dest: " << travelDistance << " miles";
+	} else {
+		cout << "Sorry, destination unreachable";
+	}
+	cout << endl;
+
+	//////////////////////////////////////////////////////////////
+	// Output Path Footway Node Route from Start to Destination //
+	//////////////////////////////////////////////////////////////
+
+	if (travelDistance != INF && snapped) {
+		cout << "Path: (start)->";
+
+		for (uint32_t index : path) {
+			cout << mapper.toID(index) << "->";
+		}
 
-			// Closer footway node to destination building found
-			if (currentDestDistance < closestDestDistance) {
-				closestDestDistance = currentDestDistance;
-				destID = currCoordinates.ID;
+		cout << "(dest)" << endl;
+	} else if (travelDistance != INF) {
+		cout << "Path: ";
+
+		for (size_t i = 0; i < path.size(); i++) {
+			if (i == path.size() - 1) {
+				cout << mapper.toID(path[i]) << endl;
+			} else {
+				cout << mapper.toID(path[i]) << "->";
 			}
 		}
 	}
+}
 
-	/////////////////////////////////////////////////
-	// Return closest coordinates to each building //
-	/////////////////////////////////////////////////
+//
+// Usage: application.exe [--segments] [dijkstra | bidirectional | astar | alt | ch | radix] [threads [matrix file]]
+//
+// The optional argument picks the search used to route between buildings;
+// the default is astar.  All of them print the same routes.  alt keeps its
+// landmark tables next to the map file (e.g. map.osm.landmarks) and only
+// rebuilds them when the map changes.  ch builds a contraction hierarchy
+// at startup, which takes a while but makes every query very fast.
+//
+// Giving a # of threads switches to batch mode for scripted runs: every
+// query is read up front (until # or the end of the input), all of the
+// routes are computed in parallel on that many threads (0 = one per
+// core), and then the output is printed exactly as one query at a time
+// would have printed it.
+//
+// Giving a matrix file as well writes the walking distance between every
+// pair of buildings (from the footway node nearest to each) to that file
+// instead of answering queries: as CSV with the building names if the
+// file name ends in .csv, else in the dense binary form of matrix.h.  With
+// ch the table is filled from the contraction hierarchy, otherwise by one
+// Dijkstra per building on the given # of threads.
+//
+// --segments joins each building to the closest point on any footway
+// segment (see rtree.h) rather than to the closest footway node, and
+// routes between those points with Dijkstra.  It does not apply to the
+// matrix file, which stays node to node.
+//
+int main(int argc, char *argv[]) {
+	RouteAlgorithm algorithm = ROUTE_ASTAR;
+	int numThreads = -1;  // -1 = interactive, one query at a time
+	bool snapToSegments = false;
+	vector<string> args;  // Everything but the -- options
+	string usage = string("Usage: ") + argv[0] + " [--segments] [dijkstra | "
+	"bidirectional | astar | alt | ch | radix] [threads [matrix file]]";
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--segments") == 0) {
+			snapToSegments = true;
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
 
-	startCoords = mapNodes.at(startID);
-	destCoords = mapNodes.at(destID);
-}
+	if (args.size() > 0 && !parseRouteAlgorithm(args[0], algorithm)) {
+		cout << "**Error: unknown routing algorithm '" << args[0] << "'." << endl;
+		cout << usage << endl;
+		return 0;
+	}
+
+	if (args.size() > 1 && (sscanf(args[1].c_str(), "%d", &numThreads) != 1 || numThreads < 0)) {
+		cout << "**Error: bad # of threads '" << args[1] << "'." << endl;
+		cout << usage << endl;
+		return 0;
+	}
+
+	string matrixFilename = (args.size() > 2) ? args[2] : "";
 
-int main() {
 	// maps a Node ID to it's coordinates (lat, lon)
 	map<long long, Coordinates> Nodes;
 	// info about each footway, in no particular order
@@ -261,8 +412,12 @@ int main() {
 	// info about each building, in no particular order
 	vector<BuildingInfo> Buildings;
 	XMLDocument xmldoc;
-	// Graph<Node IDs, Bidirectional Distance Between>
-	graph<long long, double> G;
+	// Node IDs <-> dense indices 0..N-1
+	IDMapper mapper;
+	// NodeCoords[index] is the coordinates of node mapper.toID(index)
+	vector<Coordinates> NodeCoords;
+	// Graph<Node indices, Bidirectional Distance Between>
+	graph<uint32_t, double> G;
 
 	cout << "** Navigating UIC open street map **" << endl;
 	cout << endl;
@@ -314,236 +469,264 @@ int main() {
 	cout << "# of footways: " << Footways.size() << endl;
 	cout << "# of buildings: " << Buildings.size() << endl;
 
-	////////////////////////////
-	// Add All Nodes to Graph //
-	////////////////////////////
-
-	for (pair<long long, Coordinates> currPair : Nodes) {
-		G.addVertex(currPair.second.ID);
-	}
-
-	///////////////////////////////////////
-	// Add Edges Between Nodes Both Ways //
-	///////////////////////////////////////
+	///////////////////////////////////////////////////////////
+	// Assign Dense Indices and Add Nodes and Edges to Graph //
+	///////////////////////////////////////////////////////////
 
 	//
-	//  For each foot way
-	//		For each point on the foot way
-	//			Calculate the distance between two subsequent nodes
-	//			and add a new edge between the two points with the
-	//			calculated distance
+	// Every node is a vertex, and each pair of subsequent points on a
+	// foot way is an edge both ways (see footwaygraph.h)
 	//
 
-	// For each foot way
-	for (auto currFootway : Footways) {
-		// For each point on the foot way
-		for (int i = 0; i < (int)currFootway.Nodes.size() - 1; i++) {
-			// IDs of two points on map
-			long long p1 = currFootway.Nodes[i];
-			long long p2 = currFootway.Nodes[i + 1];
-
-			// Lat and Lon of two points
-			double p1Lat = Nodes.at(p1).Lat;
-			double p1Lon = Nodes.at(p1).Lon;
-			double p2Lat = Nodes.at(p2).Lat;
-			double p2Lon = Nodes.at(p2).Lon;
-
-			// Calculate Distance
-			double distance = distBetween2Points(p1Lat, p1Lon, p2Lat, p2Lon);
-
-			// Add edge both ways
-			G.addEdge(p1, p2, distance);
-			G.addEdge(p2, p1, distance);
-		}
-	}
+	BuildFootwayGraph(Nodes, Footways, mapper, NodeCoords, G);
 
 	cout << "# of vertices: " << G.NumVertices() << endl;
 	cout << "# of edges: " << G.NumEdges() << endl;
 	cout << endl;
 
+	//////////////////////////////////////////////////////
+	// Freeze the graph into CSR form for fast querying //
+	//////////////////////////////////////////////////////
+
+	// G is never modified after this point, so every search runs on CG
+	const csrgraph<uint32_t, double> CG(G);
+
+	/////////////////////////////////////////////////////////
+	// Index the footway nodes for nearest node lookups    //
+	/////////////////////////////////////////////////////////
+
+	const FootwayIndex footwayIndex(Footways, mapper, NodeCoords);
+
+	// Footway segments too, only with --segments
+	FootwayRTree segmentIndex;
+
+	if (snapToSegments) {
+		segmentIndex = FootwayRTree(Footways, mapper, NodeCoords);
+	}
+
+	const FootwayRTree *footwaySegments = snapToSegments ? &segmentIndex : nullptr;
+
+	//////////////////////////////////////////////////
+	// Load or Precompute ALT Landmarks When Needed //
+	//////////////////////////////////////////////////
+
+	ALTLandmarks<uint32_t> landmarks;
+
+	if (algorithm == ROUTE_ALT) {
+		string landmarksFilename = filename + ".landmarks";
+
+		// Tables built on a different map are rejected by load()
+		if (!landmarks.load(landmarksFilename, CG)) {
+			landmarks.build(CG, CG, 8);  // CG is symmetric, see above
+			landmarks.save(landmarksFilename);
+		}
+	}
+
+	/////////////////////////////////////////////////
+	// Build the Contraction Hierarchy When Needed //
+	/////////////////////////////////////////////////
+
+	ContractionHierarchy<uint32_t> CH;
+
+	if (algorithm == ROUTE_CH) {
+		CH.build(CG);
+	}
+
+	///////////////////////////////////////////////
+	// Convert Weights to Fixed Point When Needed //
+	///////////////////////////////////////////////
+
+	FixedPointWeights fixedWeights;
+
+	if (algorithm == ROUTE_RADIX) {
+		fixedWeights = FixedPointWeights(CG);
+	}
+
 	//
 	// Navigation from building to building
 	//
 	string startQuery, destQuery;
 
-	cout << "Enter start (partial name or abbreviation), or #> ";
-	getline(cin, startQuery);
-
-	while (startQuery != "#") {
-		Coordinates startBuildingCoordinates;
-		Coordinates destBuildingCoordinates;
+	if (matrixFilename != "") {
+		///////////////////////////////////////////////////////
+		// Matrix mode: every building to every building,    //
+		// each building at its nearest footway node         //
+		///////////////////////////////////////////////////////
 
-		cout << "Enter destination (partial name or abbreviation)> ";
-		getline(cin, destQuery);
+		vector<uint32_t> buildingNodes;
+		vector<string> buildingNames;
 
-		////////////////////////////////////////////////
-		// Look for start and destination coordinates //
-		////////////////////////////////////////////////
+		for (const BuildingInfo &currBuilding : Buildings) {
+			buildingNodes.push_back(footwayIndex.nearest(currBuilding.Coords));
+			buildingNames.push_back(currBuilding.Fullname);
+		}
 
-		// Indicates if start and destinations were found
-		bool startFound = false;
-		bool destFound = false;
+		DistanceMatrix table;
 
-		// Saves building names if found
-		string startBuildingFullName;
-		string destBuildingFullName;
+		if (algorithm == ROUTE_CH) {
+			table = ComputeDistanceMatrix(CG, CH, buildingNodes, buildingNodes);
+		} else {
+			WorkStealingScheduler scheduler(numThreads);
 
-		///////////////////////////////////////////////////////////////
-		// Search the building vector for the user inputted name.    //
-		// Checks abbreviation, if no match, the finds partial name. //
-		///////////////////////////////////////////////////////////////
+			table = ComputeDistanceMatrix(CG, buildingNodes, buildingNodes, &scheduler);
+		}
 
-		for (auto currBuilding : Buildings) {
-			// Base Case: Start and Destination Buildings are Valid
-			if (startFound && destFound) {
-				break;
-			}
+		table.setLabels(buildingNames, buildingNames);
 
-			// Check if the current building matches the start building query
-			if (!startFound) {
-				startFound = checkForMatch(currBuilding, startQuery,
-				startBuildingFullName, startBuildingCoordinates);
-			}
+		bool csv = matrixFilename.size() >= 4 &&
+		matrixFilename.compare(matrixFilename.size() - 4, 4, ".csv") == 0;
+		bool written = csv ? table.writeCSV(matrixFilename) : table.writeBinary(matrixFilename);
 
-			// Check if the current building matches the dest building query
-			if (!destFound) {
-				destFound = checkForMatch(currBuilding, destQuery,
-				destBuildingFullName, destBuildingCoordinates);
+		if (!written) {
+			cout << "**Error: unable to write distance matrix to '" << matrixFilename << "'." << endl;
+		} else {
+			cout << "Wrote " << table.NumRows() << " x " << table.NumCols()
+			<< " distance matrix to " << matrixFilename << endl;
+		}
+	} else if (numThreads >= 0) {
+		//////////////////////////////////////////////////////////////
+		// Batch mode: read every query, route them all in parallel, //
+		// then print exactly what the interactive loop would       //
+		//////////////////////////////////////////////////////////////
+
+		vector<Trip> trips;
+		vector<pair<uint32_t, uint32_t>> queries;
+		vector<pair<SegmentSnap, SegmentSnap>> snappedQueries;  // --segments
+		vector<int> queryOf;  // [trip #] = its # in queries, or -1
+
+		while (getline(cin, startQuery) && startQuery != "#") {
+			getline(cin, destQuery);
+
+			trips.push_back(planTrip(startQuery, destQuery, Buildings,
+			footwayIndex, footwaySegments, NodeCoords));
+			queryOf.push_back(-1);
+
+			const Trip &trip = trips.back();
+
+			if (trip.snapped) {
+				queryOf.back() = (int) snappedQueries.size();
+				snappedQueries.push_back(make_pair(trip.startSnap, trip.destSnap));
+			} else if (trip.startFound && trip.destFound) {
+				queryOf.back() = (int) queries.size();
+				queries.push_back(make_pair(
+				mapper.toIndex(trip.startPointCoords.ID),
+				mapper.toIndex(trip.destPointCoords.ID)));
 			}
 		}
 
-		////////////////////////////////////////////////////////
-		// Case: Start and/or Destination Point was not Found //
-		////////////////////////////////////////////////////////
+		BatchRouter batch(CG, NodeCoords, algorithm, &landmarks, &CH,
+		&fixedWeights, numThreads);
+		vector<RouteResult> results = snapToSegments ?
+		batch.routeSnapped(snappedQueries) : batch.route(queries);
 
-		if (!startFound) {
-			cout << "Start building not found" << endl;
-		} else {
-			if (!destFound) {
-				cout << "Destination building not found" << endl;
-			}
+		// Per-thread load, on stderr so the transcript on stdout is unchanged
+		vector<WorkerStats> stats = batch.stats();
+
+		for (size_t w = 0; w < stats.size(); w++) {
+			cerr << "thread " << w << ": " << stats[w].Tasks << " routes, "
+			<< stats[w].Steals << " chunks stolen, " << stats[w].BusySeconds
+			<< " s busy" << endl;
 		}
 
-		////////////////////////////////////////////////////////
-		// Look for and return path from start to destination //
-		////////////////////////////////////////////////////////
+		cout << "Enter start (partial name or abbreviation), or #> ";
 
-		if (startFound && destFound) {
-			Coordinates startPointCoords;
-			Coordinates destPointCoords;
+		for (size_t i = 0; i < trips.size(); i++) {
+			cout << "Enter destination (partial name or abbreviation)> ";
 
-			////////////////////////////////////////////////////////////////////
-			// Find closest footway nodes for start and destination buildings //
-			////////////////////////////////////////////////////////////////////
+			printTrip(trips[i]);
 
-			findStartAndDest(startBuildingCoordinates, destBuildingCoordinates,
-			startPointCoords, destPointCoords, Footways, Nodes);
+			if (queryOf[i] != -1) {
+				const RouteResult &result = results[queryOf[i]];
 
-			////////////////////
-			// Output Results //
-			////////////////////
+				printRoute(result.Distance, result.Path, mapper, trips[i].snapped);
+			}
 
-			// Print Start Building Point
-			cout << "Starting point:" << endl;
-			cout << " " << startBuildingFullName << endl;
-			cout << " (" << startBuildingCoordinates.Lat << ", "
-			<< startBuildingCoordinates.Lon << ")" << endl;;
+			cout << endl;
+			cout << "Enter start (partial name or abbreviation), or #> ";
+		}
+	} else {
+		// Runs every query, reusing its search workspaces between them
+		Router router(CG, NodeCoords, algorithm, &landmarks, &CH, &fixedWeights);
 
-			// Print Destination Building Point
-			cout << "Destination point:" << endl;
-			cout << " " << destBuildingFullName << endl;
-			cout << " (" << destBuildingCoordinates.Lat << ", "
-			<< destBuildingCoordinates.Lon << ")" << endl;
+		// Repeated starts (e.g. a kiosk's own building) reuse their whole
+		// shortest path tree, see Router::cacheTrees
+		router.cacheTrees(8);
 
-			cout << endl;
+		// Popular building pairs skip the node lookup and the search
+		// entirely; cleared if it is ever attached to a different graph
+		RouteCache routes(RouteCacheCapacity);
 
-			// Print Nearest Footway Node to Start Building
-			cout << "Nearest start node:" << endl;
-			cout << " " << startPointCoords.ID << endl;
-			cout << " (" << startPointCoords.Lat << ", "
-			<< startPointCoords.Lon << ")";
-			cout << endl;
+		routes.setGraph(CG);
 
-			// Print Nearest Footway Node to Destination Building
-			cout << "Nearest destination node:" << endl;
-			cout << " " << destPointCoords.ID << endl;
-			cout << " (" << destPointCoords.Lat << ", "
-			<< destPointCoords.Lon << ")";
-			cout << endl;
+		cout << "Enter start (partial name or abbreviation), or #> ";
+		getline(cin, startQuery);
 
-			cout << endl;
+		while (startQuery != "#") {
+			cout << "Enter destination (partial name or abbreviation)> ";
+			getline(cin, destQuery);
 
-			//////////////////////////////
-			// Run dijkstra's algorithm //
-			//////////////////////////////
+			Trip trip = findBuildings(startQuery, destQuery, Buildings);
+			const CachedRoute *cached = nullptr;
+			CachedRoute route;
 
-			cout << "Navigating with Dijkstra..." << endl;
-			map<long long, double> distances;
-			map<long long, long long>predecessors;
-			vector<long long> visited = Dijkstra(G, startPointCoords.ID,
-										distances, predecessors);
+			if (trip.startFound && trip.destFound) {
+				cached = routes.find(trip.startBuilding, trip.destBuilding);
 
-			double travelDistance = distances.at(destPointCoords.ID);
+				if (cached == nullptr) {
+					locateTrip(trip, footwayIndex, footwaySegments, NodeCoords);
 
-			///////////////////////////////////////////////////
-			// Output Reachability of Destination from Start //
-			///////////////////////////////////////////////////
+					route.StartNode = trip.startPointCoords;
+					route.DestNode = trip.destPointCoords;
+					route.StartSnap = trip.startSnap;
+					route.DestSnap = trip.destSnap;
 
-			if (travelDistance != INF) {
-				cout << "Distance to dest: " << travelDistance << " miles";
-			} else {
-				cout << "Sorry, destination unreachable";
-			}
-			cout << endl;
+					if (trip.snapped) {
+						route.Distance = router.routeSnapped(trip.startSnap,
+						trip.destSnap, route.Path);
+					} else {
+						//
+						// Only the route to the destination is needed, so the
+						// router stops as soon as it has found it (see router.h).
+						//
+						uint32_t startIndex = mapper.toIndex(route.StartNode.ID);
+						uint32_t destIndex = mapper.toIndex(route.DestNode.ID);
+
+						route.Distance = router.route(startIndex, destIndex, route.Path);
+					}
 
-			///////////////////////////////////////////////////////////
-			// Save path from Destination to Start Vertex in a Stack //
-			///////////////////////////////////////////////////////////
-
-			//
-			// Given the predecessors map from Dijkstra's, we can only pull
-			// the path from the destination footway vertex to the start vertex.
-			// We have to reverse the order to get the path from
-			// the start vertex to the destination vertex
-			//
-			stack<long long> path;  // Store the path from start to destiantion
-
-			if (startFound && destFound) {
-				path.push(destPointCoords.ID);
-				long long predecessorID = predecessors.at(destPointCoords.ID);
-				while (predecessorID != -1) {  // Path ends at -1
-					path.push(predecessorID);
-					predecessorID = predecessors.at(predecessorID);
+					routes.insert(trip.startBuilding, trip.destBuilding, route);
+					cached = &route;
 				}
+
+				trip.startPointCoords = cached->StartNode;
+				trip.destPointCoords = cached->DestNode;
+				trip.startSnap = cached->StartSnap;
+				trip.destSnap = cached->DestSnap;
+				trip.snapped = snapToSegments;
 			}
 
-			//////////////////////////////////////////////////////////////
-			// Output Path Footway Node Route from Start to Destination //
-			//////////////////////////////////////////////////////////////
+			printTrip(trip);
 
-			// Ouputs pathway from start to destination in correct order
-			if (travelDistance != INF) {
-				cout << "Path: ";
+			////////////////////////////////////////////////////////
+			// Look for and return path from start to destination //
+			////////////////////////////////////////////////////////
 
-				for (int i = path.size(); i > 0; i--) {
-					if (i == 1) {
-						cout << path.top() << endl;
-						path.pop();
-					} else {
-						cout << path.top() << "->";
-						path.pop();
-					}
-				}
+			if (cached != nullptr) {
+				printRoute(cached->Distance, cached->Path, mapper, trip.snapped);
 			}
-		}
 
-		////////////////////////////
-		// Prompt for next search //
-		////////////////////////////
+			////////////////////////////
+			// Prompt for next search //
+			////////////////////////////
 
-		cout << endl;
-		cout << "Enter start (partial name or abbreviation), or #> ";
-		getline(cin, startQuery);
+			cout << endl;
+			cout << "Enter start (partial name or abbreviation), or #> ";
+			getline(cin, startQuery);
+		}
+
+		// On stderr so the transcript on stdout is unchanged
+		cerr << "route cache: " << routes.hits() << " hits, " << routes.misses()
+		<< " misses" << endl;
 	}
 
 	//
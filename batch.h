@@ -0,0 +1,135 @@
+// batch.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// BatchRouter answers a whole list of route queries at once, spread over
+// several threads.  The graph and the precomputed data are shared and
+// read-only; each thread gets its own Router (see router.h) and therefore
+// its own search workspaces, which are kept from one batch to the next.
+// Queries are handed out by a work-stealing scheduler (see scheduler.h),
+// so a thread that drew short routes helps out with the long ones.
+//
+// Example:
+//    BatchRouter batch(CG, NodeCoords, ROUTE_ASTAR);
+//    vector<RouteResult> results = batch.route(queries);
+//    // results[i] is the route for queries[i]
+//
+// Build with -pthread.
+//
+
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "router.h"
+#include "scheduler.h"
+
+using namespace std;
+
+//
+// RouteResult
+//
+// Answer to one query: the distance in miles (INF if unreachable) and the
+// node indices along the route (empty if unreachable).
+//
+struct RouteResult {
+	double Distance;
+	vector<uint32_t> Path;
+
+	RouteResult() {
+		Distance = INF;
+	}
+};
+
+class BatchRouter {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	WorkStealingScheduler Scheduler;
+	vector<Router> Routers;  // [worker #] = that worker's router
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Same arguments as Router, plus the # of threads to use (<= 0 means
+	// one per core).  Everything passed in must outlive the BatchRouter.
+	// A BatchRouter owns threads, so it cannot be copied.
+	//
+	BatchRouter(const csrgraph<uint32_t, double> &G,
+	            const vector<Coordinates> &NodeCoords,
+	            RouteAlgorithm algorithm,
+	            const ALTLandmarks<uint32_t> *landmarks = nullptr,
+	            const ContractionHierarchy<uint32_t> *CH = nullptr,
+	            const FixedPointWeights *fixedWeights = nullptr,
+	            int numThreads = 0)
+		: Scheduler(numThreads) {
+		Routers.assign(Scheduler.NumWorkers(),
+		Router(G, NodeCoords, algorithm, landmarks, CH, fixedWeights));
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumThreads() const {
+		return (int) Routers.size();
+	}
+
+	//
+	// route
+	//
+	// Routes every (start index, destination index) query and returns the
+	// results in the same order as the queries.
+	//
+	vector<RouteResult> route(const vector<pair<uint32_t, uint32_t>> &queries) {
+		vector<RouteResult> results(queries.size());
+
+		Scheduler.parallelFor(queries.size(), [&](size_t i, int worker) {
+			results[i].Distance = Routers[worker].route(queries[i].first,
+			queries[i].second, results[i].Path);
+		});
+
+		return results;
+	}
+
+	//
+	// routeSnapped
+	//
+	// Same for (start, destination) pairs of points snapped onto footway
+	// segments, see Router::routeSnapped.
+	//
+	vector<RouteResult> routeSnapped(const vector<pair<SegmentSnap, SegmentSnap>> &queries) {
+		vector<RouteResult> results(queries.size());
+
+		Scheduler.parallelFor(queries.size(), [&](size_t i, int worker) {
+			results[i].Distance = Routers[worker].routeSnapped(queries[i].first,
+			queries[i].second, results[i].Path);
+		});
+
+		return results;
+	}
+
+	//
+	// stats / resetStats
+	//
+	// Per-thread counters of the scheduler, summed over every batch since
+	// the last reset, see WorkerStats.
+	//
+	vector<WorkerStats> stats() const {
+		return Scheduler.stats();
+	}
+
+	void resetStats() {
+		Scheduler.resetStats();
+	}
+};
@@ -0,0 +1,217 @@
+// benchmark.cpp
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Times DijkstraPath (see algs.h) with each priority queue policy on the
+// same random node-to-node queries over a map's footway graph, and checks
+// that every policy finds the same routes as the default binary heap.
+//
+// Then times each distance metric (see metrics.h) on every footway edge
+// and shows how far it is from the haversine distance (same sphere) and
+// from Vincenty's (WGS84 ellipsoid).
+//
+// Usage: ./benchmark.exe [map filename] [# of queries]
+//
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "tinyxml2.h"
+#include "graph.h"
+#include "csrgraph.h"
+#include "algs.h"
+#include "daryheap.h"
+#include "pairingheap.h"
+#include "radixheap.h"
+#include "bucketqueue.h"
+#include "metrics.h"
+#include "idmap.h"
+#include "footwaygraph.h"
+#include "osm.h"
+
+using namespace std;
+using namespace tinyxml2;
+
+//
+// loadFootwayGraph
+//
+// Builds the footway graph of a map with BuildFootwayGraph, just like
+// application.cpp.  coords gets the node coordinates and from / to the
+// ends of every footway segment.  Returns false if the map cannot be
+// loaded.
+//
+bool loadFootwayGraph(const string &filename, csrgraph<uint32_t, double> &CG,
+vector<Coordinates> &coords, vector<uint32_t> &from, vector<uint32_t> &to) {
+	XMLDocument xmldoc;
+	map<long long, Coordinates> Nodes;
+	vector<FootwayInfo> Footways;
+	IDMapper mapper;
+	graph<uint32_t, double> G;
+
+	if (!LoadOpenStreetMap(filename, xmldoc)) {
+		return false;
+	}
+
+	ReadMapNodes(xmldoc, Nodes);
+	ReadFootways(xmldoc, Footways);
+
+	BuildFootwayGraph(Nodes, Footways, mapper, coords, G, from, to);
+
+	CG = csrgraph<uint32_t, double>(G);
+
+	return true;
+}
+
+//
+// timeQueue
+//
+// Runs every query with the given queue policy and prints the time taken.
+// Returns the routes found, flattened, so they can be compared.
+//
+template<typename QueueT>
+vector<uint32_t> timeQueue(const string &name, const csrgraph<uint32_t, double> &CG,
+const vector<pair<uint32_t, uint32_t>> &queries, QueueT &queue) {
+	SearchWorkspace state;
+	vector<uint32_t> path, routes;
+	double total = 0;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (const pair<uint32_t, uint32_t> &query : queries) {
+		double distance = DijkstraPath(CG, query.first, query.second, path, state, queue);
+
+		total += (distance == INF) ? 0 : distance;
+		routes.insert(routes.end(), path.begin(), path.end());
+	}
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+	cout << left << setw(22) << name << right << setw(10) << fixed << setprecision(1)
+	<< elapsed.count() << " ms" << setw(10) << setprecision(1)
+	<< 1000 * elapsed.count() / queries.size() << " us/query"
+	<< "   total " << setprecision(6) << total << " miles" << endl;
+
+	return routes;
+}
+
+//
+// timeMetric
+//
+// Measures every segment from[i] -> to[i] with MetricT, over and over,
+// and prints the time per distance and the largest difference from the
+// haversine and Vincenty distances of the same segments.
+//
+template<typename MetricT>
+void timeMetric(const vector<Coordinates> &coords,
+const vector<uint32_t> &from, const vector<uint32_t> &to,
+const vector<double> &haversine, const vector<double> &vincenty) {
+	const double mmPerMile = 1609344;
+	const int repeats = 1 + 2000000 / (int) from.size();  // ~2M distances
+	MetricCoordinates<MetricT> points(coords);
+	vector<double> miles(from.size());
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (int r = 0; r < repeats; r++) {
+		for (size_t i = 0; i < from.size(); i++) {
+			miles[i] = points.miles(from[i], to[i]);
+		}
+	}
+
+	chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+	double fromHaversine = 0;
+	double fromVincenty = 0;
+
+	for (size_t i = 0; i < from.size(); i++) {
+		fromHaversine = max(fromHaversine, fabs(miles[i] - haversine[i]));
+		fromVincenty = max(fromVincenty, fabs(miles[i] - vincenty[i]));
+	}
+
+	cout << left << setw(22) << MetricT::name() << right << setw(10) << fixed << setprecision(1)
+	<< elapsed.count() / repeats / from.size() << " ns/distance"
+	<< setw(12) << setprecision(4) << fromHaversine * mmPerMile << " mm"
+	<< setw(12) << setprecision(1) << fromVincenty * mmPerMile << " mm" << endl;
+}
+
+int main(int argc, char *argv[]) {
+	string filename = (argc > 1) ? argv[1] : "map.osm";
+	int numQueries = (argc > 2) ? atoi(argv[2]) : 2000;
+	csrgraph<uint32_t, double> CG;
+	vector<Coordinates> coords;
+	vector<uint32_t> from, to;
+
+	if (!loadFootwayGraph(filename, CG, coords, from, to) || CG.NumVertices() == 0 || numQueries <= 0) {
+		cout << "Usage: " << argv[0] << " [map filename] [# of queries]" << endl;
+		return 0;
+	}
+
+	cout << "# of vertices: " << CG.NumVertices() << endl;
+	cout << "# of edges: " << CG.NumEdges() << endl;
+	cout << "# of queries: " << numQueries << endl;
+	cout << endl;
+
+	// Same pseudo-random queries every run
+	vector<pair<uint32_t, uint32_t>> queries;
+	uint32_t seed = 12345;
+
+	for (int i = 0; i < numQueries; i++) {
+		seed = seed * 1103515245 + 12345;
+		uint32_t from = (seed >> 8) % CG.NumVertices();
+		seed = seed * 1103515245 + 12345;
+		uint32_t to = (seed >> 8) % CG.NumVertices();
+
+		queries.push_back(make_pair(from, to));
+	}
+
+	vector<pair<int, double>> binaryStorage;
+	BinaryHeapQueue binary(binaryStorage);
+	IndexedDaryHeap<2> dary2;
+	IndexedDaryHeap<4> dary4;
+	IndexedDaryHeap<8> dary8;
+	PairingHeap pairing;
+	RadixHeapQueue radix;
+	BucketQueue bucket(CG);
+
+	vector<uint32_t> expected = timeQueue("binary heap", CG, queries, binary);
+	bool same = true;
+
+	same &= (timeQueue("indexed 2-ary heap", CG, queries, dary2) == expected);
+	same &= (timeQueue("indexed 4-ary heap", CG, queries, dary4) == expected);
+	same &= (timeQueue("indexed 8-ary heap", CG, queries, dary8) == expected);
+	same &= (timeQueue("pairing heap", CG, queries, pairing) == expected);
+	same &= (timeQueue("radix heap", CG, queries, radix) == expected);
+	same &= (timeQueue("bucket queue", CG, queries, bucket) == expected);
+
+	cout << endl;
+	cout << (same ? "All queues found the same routes." : "**Error: routes differ between queues.") << endl;
+	cout << endl;
+
+	//////////////////////////////////////
+	// Distance metrics on every edge  //
+	//////////////////////////////////////
+
+	vector<double> haversine, vincenty;
+
+	MetricDistances<HaversineMetric>(coords, from, to, haversine);
+	MetricDistances<VincentyMetric>(coords, from, to, vincenty);
+
+	cout << "# of footway segments: " << from.size() << endl;
+	cout << left << setw(22) << "metric" << right << setw(22) << "time"
+	<< setw(15) << "vs haversine" << setw(15) << "vs vincenty" << endl;
+
+	if (!from.empty()) {
+		timeMetric<LawOfCosinesMetric>(coords, from, to, haversine, vincenty);
+		timeMetric<HaversineMetric>(coords, from, to, haversine, vincenty);
+		timeMetric<EquirectangularMetric>(coords, from, to, haversine, vincenty);
+		timeMetric<VincentyMetric>(coords, from, to, haversine, vincenty);
+	}
+
+	return same ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// bucketqueue.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Bucket queue (Dial's algorithm) for Dijkstra over double distances.
+//
+// Distances are grouped into buckets of a fixed width: bucket b holds
+// distances in [b * Width, (b + 1) * Width).  Dijkstra only pushes
+// distances between the current minimum and the minimum plus the largest
+// edge weight, so a ring of (largest weight / Width) + 3 buckets is
+// enough, reused cyclically as the search moves outward.  Push is a plain
+// append; pop walks forward to the first nonempty bucket and picks the
+// smallest entry in it.  Picking the exact minimum (rather than any entry
+// of the bucket) keeps the visiting order identical to the binary heap.
+//
+// Buckets should be narrow enough to hold only a few entries each but
+// wide enough that pop does not walk over many empty ones.  The graph
+// constructor uses a quarter of the average edge weight.
+//
+// Example:
+//    BucketQueue queue(CG);
+//    DijkstraPath(CG, startV, destV, path, workspace, queue);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#include "csrgraph.h"
+
+using namespace std;
+
+class BucketQueue {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<vector<pair<int, double>>> Buckets;  // Ring of (index, distance)
+	double Width;
+	long long Current;  // Bucket # of the smallest distance in the queue
+	int Size;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	void init(double bucketWidth, double maxWeight) {
+		if (!(bucketWidth > 0) || !(maxWeight >= 0)) {
+			throw invalid_argument("BucketQueue: bucket width must be positive");
+		}
+
+		Width = bucketWidth;
+		Buckets.assign((size_t) (maxWeight / bucketWidth) + 3, vector<pair<int, double>>());
+		Current = 0;
+		Size = 0;
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Buckets of the given width, for a graph whose largest edge weight is
+	// maxWeight.  Throws invalid_argument if bucketWidth is not positive.
+	//
+	BucketQueue(double bucketWidth, double maxWeight) {
+		init(bucketWidth, maxWeight);
+	}
+
+	//
+	// Buckets sized for the edge weights of G, see above.
+	//
+	template<typename VertexT>
+	explicit BucketQueue(const csrgraph<VertexT, double> &G) {
+		double total = 0;
+		double maxWeight = 0;
+
+		for (int e = 0; e < G.NumEdges(); e++) {
+			total += G.edgeWeight(e);
+			maxWeight = max(maxWeight, G.edgeWeight(e));
+		}
+
+		double width = (total > 0) ? total / G.NumEdges() / 4 : 1;
+
+		init(width, maxWeight);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// clear
+	//
+	// Empties the queue; bucket storage is kept.
+	//
+	void clear(int /*numVertices*/) {
+		for (vector<pair<int, double>> &bucket : Buckets) {
+			bucket.clear();
+		}
+
+		Current = 0;
+		Size = 0;
+	}
+
+	bool empty() const {
+		return Size == 0;
+	}
+
+	int size() const {
+		return Size;
+	}
+
+	//
+	// push
+	//
+	// Adds index with the given distance.  The distance must be at least
+	// the last one popped and at most that plus the largest edge weight;
+	// throws logic_error otherwise.
+	//
+	void push(int index, double distance) {
+		long long bucket = (long long) (distance / Width);
+
+		if (bucket < Current || bucket - Current >= (long long) Buckets.size()) {
+			throw logic_error("BucketQueue::push: distance outside the bucket ring");
+		}
+
+		Buckets[bucket % Buckets.size()].push_back(make_pair(index, distance));
+		Size++;
+	}
+
+	//
+	// pop
+	//
+	// Removes and returns the entry with the smallest distance (ties go
+	// to the smaller index).  The queue must not be empty.
+	//
+	pair<int, double> pop() {
+		while (Buckets[Current % Buckets.size()].empty()) {
+			Current++;
+		}
+
+		vector<pair<int, double>> &bucket = Buckets[Current % Buckets.size()];
+		size_t best = 0;
+
+		for (size_t i = 1; i < bucket.size(); i++) {
+			if (bucket[i].second < bucket[best].second ||
+			(bucket[i].second == bucket[best].second && bucket[i].first < bucket[best].first)) {
+				best = i;
+			}
+		}
+
+		pair<int, double> smallest = bucket[best];
+
+		bucket[best] = bucket.back();
+		bucket.pop_back();
+		Size--;
+
+		return smallest;
+	}
+};
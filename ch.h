@@ -0,0 +1,630 @@
+// ch.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Contraction Hierarchies (CH).
+//
+// Preprocessing puts the vertices in order of "importance" and contracts
+// them one at a time, least important first.  Contracting v removes it
+// from the graph; for each pair of neighbors u -> v -> x whose shortest
+// path went through v, a shortcut edge u -> x is added with the combined
+// weight, unless a "witness" search finds another path that is at least
+// as short.  Each shortcut remembers the vertex v it skips so a path can
+// be unpacked back into original edges.
+//
+// A query then runs a bidirectional Dijkstra that only ever climbs the
+// order: forward from the start over edges to more important vertices,
+// backward from the destination the same way.  Both searches stay tiny,
+// because the important vertices (the "highways" of the map) are where
+// they meet.
+//
+// Example:
+//    ContractionHierarchy<uint32_t> CH;
+//    CH.build(CG);
+//    double miles = CH.route(CG, startV, destV, path, forward, backward);
+//
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "csrgraph.h"
+#include "algs.h"
+
+using namespace std;
+
+template<typename VertexT>
+class ContractionHierarchy {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Type Definitions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Arc: an edge of the graph being contracted.  Middle is the vertex
+	// a shortcut skips, or -1 for an original edge.
+	//
+	struct Arc {
+		int Other;     // Target of an out-arc, source of an in-arc
+		double Weight;
+		int Middle;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<int> Rank;  // [index] = position in the contraction order
+
+	//
+	// Search graphs, in CSR form (see csrgraph.h):
+	//   Up:   edge v -> Targets with Rank[target] > Rank[v]
+	//   Down: edge Sources -> v with Rank[source] > Rank[v], stored at v
+	//         so the backward search can climb from v to the source
+	//
+	vector<int> UpOffsets, UpTargets, UpMiddles;
+	vector<double> UpWeights;
+	vector<int> DownOffsets, DownSources, DownMiddles;
+	vector<double> DownWeights;
+
+	int nShortcuts;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Preprocessing Helpers
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// witnessSearch
+	//
+	// Dijkstra from source over the uncontracted vertices, skipping
+	// "skip", until maxDistance is exceeded or settleLimit vertices have
+	// been settled.  A shortcut is only left out when a witness is found,
+	// so stopping early just costs an extra (harmless) shortcut.
+	//
+	static void witnessSearch(const vector<vector<Arc>> &Out,
+	const vector<bool> &contracted, int source, int skip, double maxDistance,
+	int settleLimit, SearchWorkspace &state) {
+		prioritizeIndex prioritize;
+
+		state.reset((int) Out.size());
+
+		vector<pair<int, double>> &queue = state.heap();
+
+		state.update(source, 0, -1);
+		queue.push_back(make_pair(source, 0));
+
+		int settledCount = 0;
+
+		while (!queue.empty()) {
+			pop_heap(queue.begin(), queue.end(), prioritize);
+			pair<int, double> top = queue.back();
+			queue.pop_back();
+
+			if (state.settled(top.first)) {
+				continue;
+			}
+
+			if (top.second > maxDistance || settledCount++ >= settleLimit) {
+				break;
+			}
+
+			state.settle(top.first);
+
+			for (const Arc &arc : Out[top.first]) {
+				if (contracted[arc.Other] || arc.Other == skip) {
+					continue;
+				}
+
+				if (state.relax(arc.Other, top.second + arc.Weight, top.first)) {
+					queue.push_back(make_pair(arc.Other, top.second + arc.Weight));
+					push_heap(queue.begin(), queue.end(), prioritize);
+				}
+			}
+		}
+	}
+
+	//
+	// contract
+	//
+	// Finds the shortcuts needed to remove v.  If simulate is true they
+	// are only counted (to rank v); otherwise they are added to Out/In.
+	// Returns the # of shortcuts.
+	//
+	static int contract(int v, bool simulate, vector<vector<Arc>> &Out,
+	vector<vector<Arc>> &In, const vector<bool> &contracted,
+	SearchWorkspace &state) {
+		// Witness searches are cut short after this many settled vertices
+		const int settleLimit = simulate ? 50 : 500;
+		int shortcuts = 0;
+
+		double maxOut = 0;
+
+		for (const Arc &out : Out[v]) {
+			if (!contracted[out.Other]) {
+				maxOut = max(maxOut, out.Weight);
+			}
+		}
+
+		// Shortcuts never touch v's own arcs, so these stay valid below
+		for (const Arc &in : In[v]) {
+			int u = in.Other;
+
+			if (contracted[u] || u == v) {
+				continue;
+			}
+
+			witnessSearch(Out, contracted, u, v, in.Weight + maxOut, settleLimit, state);
+
+			for (const Arc &out : Out[v]) {
+				int x = out.Other;
+				double viaV = in.Weight + out.Weight;
+
+				if (contracted[x] || x == u || x == v || state.distance(x) <= viaV) {
+					continue;  // witness found, no shortcut needed
+				}
+
+				shortcuts++;
+
+				if (!simulate) {
+					addArc(Out, In, u, x, viaV, v);
+				}
+			}
+		}
+
+		return shortcuts;
+	}
+
+	//
+	// addArc
+	//
+	// Adds the arc from -> to, or lowers the weight of the existing one.
+	//
+	static void addArc(vector<vector<Arc>> &Out, vector<vector<Arc>> &In,
+	int from, int to, double weight, int middle) {
+		for (Arc &out : Out[from]) {
+			if (out.Other == to) {
+				if (weight < out.Weight) {
+					out.Weight = weight;
+					out.Middle = middle;
+
+					for (Arc &in : In[to]) {
+						if (in.Other == from) {
+							in.Weight = weight;
+							in.Middle = middle;
+						}
+					}
+				}
+
+				return;
+			}
+		}
+
+		Out[from].push_back(Arc{to, weight, middle});
+		In[to].push_back(Arc{from, weight, middle});
+	}
+
+	//
+	// findArc
+	//
+	// Looks up the search-graph arc from -> to, returning its middle
+	// vertex (-1 for an original edge) or -2 if there is no such arc.
+	//
+	int findArc(int from, int to) const {
+		if (Rank[from] < Rank[to]) {
+			for (int e = UpOffsets[from]; e < UpOffsets[from + 1]; e++) {
+				if (UpTargets[e] == to) {
+					return UpMiddles[e];
+				}
+			}
+		} else {
+			for (int e = DownOffsets[to]; e < DownOffsets[to + 1]; e++) {
+				if (DownSources[e] == from) {
+					return DownMiddles[e];
+				}
+			}
+		}
+
+		return -2;
+	}
+
+	//
+	// unpack
+	//
+	// Appends the original vertices of the (possibly shortcut) arc
+	// from -> to, excluding "from" itself, to indices.
+	//
+	void unpack(int from, int to, vector<int> &indices) const {
+		vector<pair<int, int>> pending;  // Arcs still to expand, as a stack
+
+		pending.push_back(make_pair(from, to));
+
+		while (!pending.empty()) {
+			pair<int, int> arc = pending.back();
+			pending.pop_back();
+
+			int middle = findArc(arc.first, arc.second);
+
+			if (middle < 0) {  // original edge
+				indices.push_back(arc.second);
+			} else {
+				// Expand the first half first, so push it last
+				pending.push_back(make_pair(middle, arc.second));
+				pending.push_back(make_pair(arc.first, middle));
+			}
+		}
+	}
+
+	//
+	// upwardSearch
+	//
+	// Dijkstra from index over one of the search graphs (Up for forward,
+	// Down for backward), to exhaustion.  reached gets every vertex
+	// settled; their distances are left in state.
+	//
+	static void upwardSearch(int index, const vector<int> &offsets,
+	const vector<int> &others, const vector<double> &weights,
+	SearchWorkspace &state, vector<int> &reached) {
+		prioritizeIndex prioritize;
+		vector<pair<int, double>> &queue = state.heap();
+
+		state.reset((int) offsets.size() - 1);
+		reached.clear();
+
+		state.update(index, 0, -1);
+		queue.push_back(make_pair(index, 0));
+
+		while (!queue.empty()) {
+			pop_heap(queue.begin(), queue.end(), prioritize);
+			pair<int, double> top = queue.back();
+			queue.pop_back();
+
+			if (state.settled(top.first)) {
+				continue;
+			}
+
+			state.settle(top.first);
+			reached.push_back(top.first);
+
+			for (int e = offsets[top.first]; e < offsets[top.first + 1]; e++) {
+				if (state.relax(others[e], top.second + weights[e], top.first)) {
+					queue.push_back(make_pair(others[e], top.second + weights[e]));
+					push_heap(queue.begin(), queue.end(), prioritize);
+				}
+			}
+		}
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	ContractionHierarchy() {
+		nShortcuts = 0;
+		UpOffsets.push_back(0);
+		DownOffsets.push_back(0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// build
+	//
+	// Contracts every vertex of G and builds the search graphs.  G may be
+	// directed; incoming arcs are collected from its outgoing ones.
+	//
+	// Node order: each vertex is ranked by its edge difference (shortcuts
+	// its contraction would add minus the edges it removes) plus the #
+	// of its neighbors already contracted, which spreads contraction
+	// evenly over the map.  Ranks are kept in a lazy priority queue: a
+	// popped vertex is re-ranked and only contracted if it is still the
+	// smallest.
+	//
+	void build(const csrgraph<VertexT, double> &G) {
+		int n = G.NumVertices();
+		vector<vector<Arc>> Out(n), In(n);
+		vector<bool> contracted(n, false);
+		vector<int> contractedNeighbors(n, 0);
+		SearchWorkspace state;
+
+		for (int v = 0; v < n; v++) {
+			for (int e = G.edgesBegin(v); e < G.edgesEnd(v); e++) {
+				int x = G.edgeTarget(e);
+
+				if (x != v) {  // self loops never help a shortest path
+					Out[v].push_back(Arc{x, G.edgeWeight(e), -1});
+					In[x].push_back(Arc{v, G.edgeWeight(e), -1});
+				}
+			}
+		}
+
+		// Edge difference + contracted neighbors, as described above
+		auto priority = [&](int v) {
+			int removed = 0;
+
+			for (const Arc &arc : Out[v]) {
+				removed += contracted[arc.Other] ? 0 : 1;
+			}
+			for (const Arc &arc : In[v]) {
+				removed += contracted[arc.Other] ? 0 : 1;
+			}
+
+			return contract(v, true, Out, In, contracted, state) - removed
+				+ contractedNeighbors[v];
+		};
+
+		/////////////////////////////////////////
+		// Contract in order of least priority //
+		/////////////////////////////////////////
+
+		priority_queue<pair<int, int>, vector<pair<int, int>>,
+			greater<pair<int, int>>> order;  // (priority, vertex)
+
+		for (int v = 0; v < n; v++) {
+			order.push(make_pair(priority(v), v));
+		}
+
+		Rank.assign(n, 0);
+		nShortcuts = 0;
+
+		int nextRank = 0;
+
+		while (!order.empty()) {
+			int v = order.top().second;
+			order.pop();
+
+			if (contracted[v]) {
+				continue;
+			}
+
+			// Lazy update: re-rank, and put back if no longer the smallest
+			int current = priority(v);
+
+			if (!order.empty() && current > order.top().first) {
+				order.push(make_pair(current, v));
+				continue;
+			}
+
+			nShortcuts += contract(v, false, Out, In, contracted, state);
+			contracted[v] = true;
+			Rank[v] = nextRank++;
+
+			for (const Arc &arc : Out[v]) {
+				contractedNeighbors[arc.Other]++;
+			}
+			for (const Arc &arc : In[v]) {
+				contractedNeighbors[arc.Other]++;
+			}
+		}
+
+		///////////////////////////////
+		// Build Up and Down graphs //
+		///////////////////////////////
+
+		UpOffsets.assign(1, 0);
+		UpTargets.clear();
+		UpWeights.clear();
+		UpMiddles.clear();
+		DownOffsets.assign(1, 0);
+		DownSources.clear();
+		DownWeights.clear();
+		DownMiddles.clear();
+
+		for (int v = 0; v < n; v++) {
+			for (const Arc &arc : Out[v]) {
+				if (Rank[arc.Other] > Rank[v]) {
+					UpTargets.push_back(arc.Other);
+					UpWeights.push_back(arc.Weight);
+					UpMiddles.push_back(arc.Middle);
+				}
+			}
+			UpOffsets.push_back((int) UpTargets.size());
+
+			for (const Arc &arc : In[v]) {
+				if (Rank[arc.Other] > Rank[v]) {
+					DownSources.push_back(arc.Other);
+					DownWeights.push_back(arc.Weight);
+					DownMiddles.push_back(arc.Middle);
+				}
+			}
+			DownOffsets.push_back((int) DownSources.size());
+		}
+	}
+
+	//
+	// NumShortcuts
+	//
+	// Returns the # of shortcuts added by build().
+	//
+	int NumShortcuts() const {
+		return nShortcuts;
+	}
+
+	//
+	// manyToMany
+	//
+	// Distances from every source to every target in G, the graph build()
+	// was run on, returned row-major: entry [i * targets.size() + j] is
+	// the distance from sources[i] to targets[j], or INF.
+	//
+	// Bucket method: one backward upward search per target leaves a
+	// (target, distance) entry in the bucket of every vertex it reaches;
+	// one forward upward search per source then scans the buckets of the
+	// vertices it reaches, and every shortest path is found at its
+	// highest vertex.  That is |sources| + |targets| tiny searches
+	// instead of |sources| full Dijkstras.
+	//
+	// The distances are added up along shortcuts rather than edge by edge
+	// in path order, so they can differ from DijkstraPath's in the last
+	// bits.
+	//
+	vector<double> manyToMany(const csrgraph<VertexT, double> &G,
+	const vector<VertexT> &sources, const vector<VertexT> &targets) const {
+		vector<double> table(sources.size() * targets.size(), INF);
+		vector<vector<pair<int, double>>> buckets(G.NumVertices());
+		vector<int> reached;
+		SearchWorkspace state;
+
+		if ((int) Rank.size() != G.NumVertices()) {
+			return table;
+		}
+
+		for (size_t j = 0; j < targets.size(); j++) {
+			int target = G.indexOf(targets[j]);
+
+			if (target >= 0) {
+				upwardSearch(target, DownOffsets, DownSources, DownWeights, state, reached);
+
+				for (int v : reached) {
+					buckets[v].push_back(make_pair((int) j, state.distance(v)));
+				}
+			}
+		}
+
+		for (size_t i = 0; i < sources.size(); i++) {
+			int source = G.indexOf(sources[i]);
+
+			if (source < 0) {
+				continue;
+			}
+
+			double *row = &table[i * targets.size()];
+
+			upwardSearch(source, UpOffsets, UpTargets, UpWeights, state, reached);
+
+			for (int u : reached) {
+				for (const pair<int, double> &entry : buckets[u]) {
+					row[entry.first] = min(row[entry.first], state.distance(u) + entry.second);
+				}
+			}
+		}
+
+		return table;
+	}
+
+	//
+	// route
+	//
+	// Shortest path from startV to destV in G, the graph build() was run
+	// on.  Returns the distance and fills path with original vertices in
+	// order, exactly like DijkstraPath (see algs.h).  forward and backward
+	// are the caller's reusable workspaces.
+	//
+	double route(const csrgraph<VertexT, double> &G, VertexT startV,
+	VertexT destV, vector<VertexT> &path, SearchWorkspace &forward,
+	SearchWorkspace &backward) const {
+		prioritizeIndex prioritize;
+		int startIndex = G.indexOf(startV);
+		int destIndex = G.indexOf(destV);
+
+		path.clear();
+
+		if (startIndex < 0 || destIndex < 0 || (int) Rank.size() != G.NumVertices()) {
+			return INF;
+		}
+
+		forward.reset(G.NumVertices());
+		backward.reset(G.NumVertices());
+
+		forward.update(startIndex, 0, -1);
+		forward.heap().push_back(make_pair(startIndex, 0));
+		backward.update(destIndex, 0, -1);
+		backward.heap().push_back(make_pair(destIndex, 0));
+
+		double mu = (startIndex == destIndex) ? 0 : INF;  // Best path so far
+		int meeting = (startIndex == destIndex) ? startIndex : -1;
+
+		//////////////////////////////////////////////////////////////
+		// Both searches only climb; each stops once it can't beat mu //
+		//////////////////////////////////////////////////////////////
+
+		while (true) {
+			bool forwardOpen = !forward.heap().empty() && forward.heap().front().second < mu;
+			bool backwardOpen = !backward.heap().empty() && backward.heap().front().second < mu;
+
+			if (!forwardOpen && !backwardOpen) {
+				break;
+			}
+
+			bool isForward = forwardOpen && (!backwardOpen ||
+				forward.heap().front().second <= backward.heap().front().second);
+
+			SearchWorkspace &state = isForward ? forward : backward;
+			SearchWorkspace &other = isForward ? backward : forward;
+			const vector<int> &offsets = isForward ? UpOffsets : DownOffsets;
+			const vector<int> &others = isForward ? UpTargets : DownSources;
+			const vector<double> &weights = isForward ? UpWeights : DownWeights;
+			vector<pair<int, double>> &queue = state.heap();
+
+			pop_heap(queue.begin(), queue.end(), prioritize);
+			pair<int, double> top = queue.back();
+			queue.pop_back();
+
+			if (state.settled(top.first)) {
+				continue;
+			}
+
+			state.settle(top.first);
+
+			for (int e = offsets[top.first]; e < offsets[top.first + 1]; e++) {
+				int next = others[e];
+
+				if (state.relax(next, top.second + weights[e], top.first)) {
+					queue.push_back(make_pair(next, state.distance(next)));
+					push_heap(queue.begin(), queue.end(), prioritize);
+				}
+
+				double otherDistance = other.distance(next);
+
+				if (otherDistance != INF && state.distance(next) + otherDistance < mu) {
+					mu = state.distance(next) + otherDistance;
+					meeting = next;
+				}
+			}
+		}
+
+		if (meeting == -1) {  // unreachable
+			return INF;
+		}
+
+		///////////////////////////////////////////////////////////
+		// Unpack start..meeting and meeting..dest into G's edges //
+		///////////////////////////////////////////////////////////
+
+		vector<int> upward;  // start..meeting over search-graph arcs
+
+		for (int index = meeting; index != -1; index = forward.predecessor(index)) {
+			upward.push_back(index);
+		}
+
+		reverse(upward.begin(), upward.end());
+
+		vector<int> indices(1, startIndex);
+
+		for (size_t i = 0; i + 1 < upward.size(); i++) {
+			unpack(upward[i], upward[i + 1], indices);
+		}
+
+		// Backward predecessors point toward the destination
+		for (int index = meeting; backward.predecessor(index) != -1;
+		index = backward.predecessor(index)) {
+			unpack(index, backward.predecessor(index), indices);
+		}
+
+		for (int index : indices) {
+			path.push_back(G.vertexAt(index));
+		}
+
+		return PathDistance(G, indices);
+	}
+};
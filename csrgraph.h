@@ -0,0 +1,364 @@
+// csrgraph.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Frozen, read-only version of graph<VertexT, WeightT> stored in compressed
+// sparse row (CSR) form.  Build the mutable graph while loading the map, then
+// freeze it once with csrgraph<VertexT, WeightT> CG(G) and run every query
+// against CG.
+//
+// Layout (n = # of vertices, m = # of edges):
+//   Vertices[0..n-1]   vertex values in sorted order, position = index
+//   Offsets[0..n]      edges of index i live in [Offsets[i], Offsets[i + 1])
+//   Targets[0..m-1]    index of the vertex each edge points to
+//   Weights[0..m-1]    weight of each edge
+//
+// Edges of a vertex are stored sorted by target, just like graph.h, so
+// neighbors() returns the same set in the same order.
+//
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <set>
+#include <cstdint>
+
+#include "graph.h"
+
+using namespace std;
+
+template<typename VertexT, typename WeightT>
+class csrgraph {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<VertexT> Vertices;  // Sorted vertex values, position is the index
+	vector<int> Offsets;       // Start of each vertex's edges, size n + 1
+	vector<int> Targets;       // Target vertex index of each edge
+	vector<WeightT> Weights;   // Weight of each edge
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Default Constructor
+	//
+	// Empty graph with no vertices and no edges.
+	//
+	csrgraph() {
+		Offsets.push_back(0);
+	}
+
+	//
+	// Freeze Constructor
+	//
+	// Copies every vertex and edge of G into contiguous arrays.  Later
+	// changes to G are not reflected in the frozen copy.
+	//
+	explicit csrgraph(const graph<VertexT, WeightT>& G) {
+		// getVertices() comes back in sorted order since AdjList is a map
+		Vertices = G.getVertices();
+
+		Offsets.reserve(Vertices.size() + 1);
+		Targets.reserve(G.NumEdges());
+		Weights.reserve(G.NumEdges());
+
+		////////////////////////////////////////////////
+		// Append each vertex's edges to the CSR rows //
+		////////////////////////////////////////////////
+
+		for (const VertexT &from : Vertices) {
+			Offsets.push_back((int) Targets.size());
+
+			// Neighbors are visited in sorted order, so each row is sorted
+			G.forEachNeighbor(from, [&](const VertexT &to, const WeightT &weight) {
+				Targets.push_back(indexOf(to));
+				Weights.push_back(weight);
+			});
+		}
+
+		Offsets.push_back((int) Targets.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// NumVertices
+	//
+	// Returns the # of vertices in the graph.
+	//
+	int NumVertices() const {
+		return (int) Vertices.size();
+	}
+
+	//
+	// NumEdges
+	//
+	// Returns the # of edges in the graph.
+	//
+	int NumEdges() const {
+		return (int) Targets.size();
+	}
+
+	//
+	// getWeight
+	//
+	// Returns the weight associated with a given edge.  If the edge
+	// exists, the weight is returned via the reference parameter and
+	// true is returned.  If the edge does not exist, the weight
+	// parameter is unchanged and false is returned.
+	//
+	bool getWeight(VertexT from, VertexT to, WeightT& weight) const {
+		int fromIndex = indexOf(from);
+		int toIndex = indexOf(to);
+
+		// Check if "from" and "to" exist
+		if (fromIndex < 0 || toIndex < 0) {
+			return false;
+		}
+
+		// Binary search the sorted row of "from" for "to"
+		vector<int>::const_iterator rowBegin = Targets.begin() + Offsets[fromIndex];
+		vector<int>::const_iterator rowEnd = Targets.begin() + Offsets[fromIndex + 1];
+		vector<int>::const_iterator edge = lower_bound(rowBegin, rowEnd, toIndex);
+
+		if (edge == rowEnd || *edge != toIndex) {
+			return false;
+		}
+
+		weight = Weights[edge - Targets.begin()];
+
+		return true;
+	}
+
+	//
+	// neighbors
+	//
+	// Returns a set containing the neighbors of v, i.e. all
+	// vertices that can be reached from v along one edge.
+	//
+	set<VertexT> neighbors(VertexT v) const {
+		set<VertexT> S;  // Return Value
+		int index = indexOf(v);
+
+		if (index >= 0) {
+			for (int e = Offsets[index]; e < Offsets[index + 1]; e++) {
+				// Rows are sorted, so hint the insert at the end
+				S.insert(S.end(), Vertices[Targets[e]]);
+			}
+		}
+
+		return S;
+	}
+
+	//
+	// forEachNeighbor
+	//
+	// Calls visit(neighbor, weight) for every edge leaving v, in sorted
+	// order, reading straight out of the CSR arrays.  See graph.h.
+	//
+	template<typename VisitorT>
+	void forEachNeighbor(VertexT v, VisitorT visit) const {
+		int index = indexOf(v);
+
+		if (index >= 0) {
+			for (int e = Offsets[index]; e < Offsets[index + 1]; e++) {
+				visit(Vertices[Targets[e]], Weights[e]);
+			}
+		}
+	}
+
+	//
+	// getVertices
+	//
+	// Returns a vector containing all the vertices in the graph.
+	//
+	vector<VertexT> getVertices() const {
+		return Vertices;
+	}
+
+	//
+	// reversed
+	//
+	// Returns the transpose of this graph: every edge (from, to, weight)
+	// becomes (to, from, weight).  Vertex indices are unchanged, so
+	// searches that run backward (e.g. from a destination) can use the
+	// same workspace indices as forward ones.
+	//
+	csrgraph reversed() const {
+		csrgraph R;  // Return Value
+
+		R.Vertices = Vertices;
+		R.Offsets.assign(Vertices.size() + 1, 0);
+		R.Targets.resize(Targets.size());
+		R.Weights.resize(Weights.size());
+
+		// Count incoming edges, then turn the counts into row offsets
+		for (int e = 0; e < NumEdges(); e++) {
+			R.Offsets[Targets[e] + 1]++;
+		}
+
+		for (int i = 0; i < NumVertices(); i++) {
+			R.Offsets[i + 1] += R.Offsets[i];
+		}
+
+		// Visiting sources in index order keeps every reversed row sorted
+		vector<int> nextSlot(R.Offsets.begin(), R.Offsets.end() - 1);
+
+		for (int from = 0; from < NumVertices(); from++) {
+			for (int e = Offsets[from]; e < Offsets[from + 1]; e++) {
+				int slot = nextSlot[Targets[e]]++;
+
+				R.Targets[slot] = from;
+				R.Weights[slot] = Weights[e];
+			}
+		}
+
+		return R;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Index Functions
+	//
+	// Algorithms that want to skip the VertexT lookups work directly on
+	// indices 0..NumVertices()-1 and edge positions 0..NumEdges()-1.
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// indexOf
+	//
+	// Returns the index of vertex v, or -1 if v is not in the graph.
+	//
+	int indexOf(VertexT v) const {
+		typename vector<VertexT>::const_iterator it =
+			lower_bound(Vertices.begin(), Vertices.end(), v);
+
+		if (it == Vertices.end() || v < *it) {
+			return -1;
+		}
+
+		return (int) (it - Vertices.begin());
+	}
+
+	//
+	// vertexAt
+	//
+	// Returns the vertex stored at the given index.
+	//
+	const VertexT& vertexAt(int index) const {
+		return Vertices[index];
+	}
+
+	//
+	// edgesBegin / edgesEnd
+	//
+	// The edges leaving index are edgesBegin(index) .. edgesEnd(index) - 1.
+	//
+	int edgesBegin(int index) const {
+		return Offsets[index];
+	}
+
+	int edgesEnd(int index) const {
+		return Offsets[index + 1];
+	}
+
+	//
+	// edgeTarget / edgeWeight
+	//
+	// Returns the target index and the weight of edge e.
+	//
+	int edgeTarget(int e) const {
+		return Targets[e];
+	}
+
+	const WeightT& edgeWeight(int e) const {
+		return Weights[e];
+	}
+
+	//
+	// dump
+	//
+	// Dumps the internal state of the graph for debugging purposes.
+	//
+	void dump(ostream& output) const {
+		output << "***************************************************" << endl;
+		output << "******************* CSR GRAPH *********************" << endl;
+
+		output << "**Num vertices: " << this->NumVertices() << endl;
+		output << "**Num edges: " << this->NumEdges() << endl;
+
+		output << endl;
+		output << "**Edges:" << endl;
+		for (int i = 0; i < NumVertices(); i++) {
+			output << "Vertex " << Vertices[i] << "'s Neighbors: ";
+
+			output << endl;
+			output << "    ";
+
+			for (int e = Offsets[i]; e < Offsets[i + 1]; e++) {
+				output << "(" << Vertices[Targets[e]] << ", "
+				<< Weights[e] << "), ";
+			}
+
+			output << endl;
+		}
+
+		output << endl;
+		output << "**************************************************" << endl;
+	}
+};
+
+//
+// GraphFingerprint
+//
+// 64-bit FNV-1a hash over the structure and weights of G.  Saved next to
+// precomputed data so a stale file is never used with a different map.
+//
+template<typename VertexT>
+uint64_t GraphFingerprint(const csrgraph<VertexT, double> &G) {
+	uint64_t hash = 14695981039346656037ULL;
+
+	// Fold the bytes of one value into the hash
+	auto mix = [&hash](const void *data, size_t size) {
+		const unsigned char *bytes = (const unsigned char *) data;
+
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	};
+
+	int numVertices = G.NumVertices();
+	int numEdges = G.NumEdges();
+
+	mix(&numVertices, sizeof(numVertices));
+	mix(&numEdges, sizeof(numEdges));
+
+	for (int v = 0; v < numVertices; v++) {
+		int degree = G.edgesEnd(v) - G.edgesBegin(v);
+
+		mix(&degree, sizeof(degree));
+
+		for (int e = G.edgesBegin(v); e < G.edgesEnd(v); e++) {
+			int target = G.edgeTarget(e);
+			double weight = G.edgeWeight(e);
+
+			mix(&target, sizeof(target));
+			mix(&weight, sizeof(weight));
+		}
+	}
+
+	return hash;
+}
@@ -0,0 +1,203 @@
+// daryheap.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Indexed d-ary min heap of (index, distance) pairs with decrease-key.
+//
+// The default Dijkstra queue (see algs.h) pushes a vertex again every time
+// its distance improves and skips the stale copies when they come off the
+// heap, so the heap can grow to one entry per relaxation.  This heap keeps
+// a position array over the dense vertex indices instead: each vertex is
+// in the heap at most once, and an improved distance moves its entry up in
+// place.  The heap never holds more than N entries.
+//
+// With Arity children per node the tree is only log_Arity(N) levels deep,
+// so the frequent decrease-keys are cheaper, while pops compare Arity
+// children per level.  4 is usually the sweet spot for road maps.
+//
+// Example:
+//    IndexedDaryHeap<4> queue;
+//    DijkstraPath(CG, startV, destV, path, workspace, queue);
+//
+
+#pragma once
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+template<int Arity>
+class IndexedDaryHeap {
+	static_assert(Arity >= 2, "IndexedDaryHeap needs at least 2 children per node");
+
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<pair<int, double>> Heap;  // (index, distance), Heap[0] is the min
+	vector<int> Position;            // [index] = slot in Heap, or -1 if absent
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Smaller distance first, ties go to the smaller index, the same
+	// order as prioritizeIndex in algs.h.
+	//
+	static bool before(const pair<int, double> &a, const pair<int, double> &b) {
+		if (a.second != b.second) {
+			return a.second < b.second;
+		}
+
+		return a.first < b.first;
+	}
+
+	void place(int slot, const pair<int, double> &entry) {
+		Heap[slot] = entry;
+		Position[entry.first] = slot;
+	}
+
+	void siftUp(int slot) {
+		pair<int, double> entry = Heap[slot];
+
+		while (slot > 0) {
+			int parent = (slot - 1) / Arity;
+
+			if (!before(entry, Heap[parent])) {
+				break;
+			}
+
+			place(slot, Heap[parent]);
+			slot = parent;
+		}
+
+		place(slot, entry);
+	}
+
+	void siftDown(int slot) {
+		pair<int, double> entry = Heap[slot];
+		int size = (int) Heap.size();
+
+		while (true) {
+			int first = slot * Arity + 1;
+
+			if (first >= size) {
+				break;
+			}
+
+			// Smallest of the (up to) Arity children
+			int best = first;
+			int last = (first + Arity < size) ? first + Arity : size;
+
+			for (int child = first + 1; child < last; child++) {
+				if (before(Heap[child], Heap[best])) {
+					best = child;
+				}
+			}
+
+			if (!before(Heap[best], entry)) {
+				break;
+			}
+
+			place(slot, Heap[best]);
+			slot = best;
+		}
+
+		place(slot, entry);
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// clear
+	//
+	// Empties the heap and makes room for indices 0..numVertices-1.  Only
+	// the entries still in the heap are reset, so this is cheap after a
+	// search that emptied most of it.
+	//
+	void clear(int numVertices) {
+		for (const pair<int, double> &entry : Heap) {
+			Position[entry.first] = -1;
+		}
+
+		Heap.clear();
+
+		if ((int) Position.size() < numVertices) {
+			Position.resize(numVertices, -1);
+		}
+	}
+
+	bool empty() const {
+		return Heap.empty();
+	}
+
+	int size() const {
+		return (int) Heap.size();
+	}
+
+	bool contains(int index) const {
+		return Position[index] != -1;
+	}
+
+	//
+	// push
+	//
+	// Inserts index with the given distance, or, if index is already in
+	// the heap, moves it to its new distance (decrease-key).
+	//
+	void push(int index, double distance) {
+		pair<int, double> entry(index, distance);
+		int slot = Position[index];
+
+		if (slot == -1) {
+			Heap.push_back(entry);
+			siftUp((int) Heap.size() - 1);
+		} else if (before(entry, Heap[slot])) {
+			Heap[slot] = entry;
+			siftUp(slot);
+		} else {
+			Heap[slot] = entry;
+			siftDown(slot);
+		}
+	}
+
+	//
+	// top
+	//
+	// Returns the (index, distance) with the smallest distance.  The heap
+	// must not be empty.
+	//
+	const pair<int, double>& top() const {
+		return Heap[0];
+	}
+
+	//
+	// pop
+	//
+	// Removes and returns the smallest entry.  The heap must not be empty.
+	//
+	pair<int, double> pop() {
+		pair<int, double> smallest = Heap[0];
+
+		Position[smallest.first] = -1;
+
+		if (Heap.size() > 1) {
+			Heap[0] = Heap.back();
+			Heap.pop_back();
+			siftDown(0);
+		} else {
+			Heap.pop_back();
+		}
+
+		return smallest;
+	}
+};
@@ -0,0 +1,313 @@
+// deltastep.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Parallel single-source shortest paths by delta-stepping.
+//
+// Dijkstra settles one vertex at a time, which leaves nothing to share
+// between threads.  Delta-stepping settles a whole band of distances at
+// once: tentative distances are kept in buckets of width Delta, and all
+// of the vertices in the lowest bucket are expanded together.  "Light"
+// edges (weight <= Delta) can put a vertex back into the same bucket, so
+// the bucket is expanded again until it stays empty; "heavy" edges can
+// only reach later buckets, so they are relaxed once per bucket.
+//
+// Each thread owns the vertices with index % numThreads == its #.  A round
+// has two halves separated by barriers (see parallel.h): every thread
+// expands its own vertices and mails relaxation requests to the owner of
+// each target, then every thread applies the requests it received.  Only
+// owners ever write a vertex's distance, so no locks are needed.
+//
+// The distances and predecessors come out exactly as Dijkstra() in
+// algs.h computes them (see DeltaStepping below).
+//
+// Example:
+//    vector<double> distances;
+//    vector<int> predecessors;
+//    DeltaStepping(CG, CG, startV, distances, predecessors);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
+
+#include "csrgraph.h"
+#include "algs.h"
+#include "parallel.h"
+
+using namespace std;
+
+//
+// DefaultDelta
+//
+// Bucket width used when the caller does not pick one: the average edge
+// weight.  Smaller widths do less wasted work but need more rounds (and
+// barriers); larger ones the reverse.
+//
+template<typename VertexT>
+double DefaultDelta(const csrgraph<VertexT, double> &G) {
+	double total = 0;
+
+	for (int e = 0; e < G.NumEdges(); e++) {
+		total += G.edgeWeight(e);
+	}
+
+	return (total > 0) ? total / G.NumEdges() : 1;
+}
+
+//
+// DeltaStepping
+//
+// Single-source version of Dijkstra() (see algs.h) that runs on
+// numThreads threads: settles every vertex reachable from startV and
+// returns them in the order Dijkstra would visit them.  distances[i] is
+// the distance from startV to G.vertexAt(i), or INF if unreachable, and
+// predecessors[i] the index before it on the path, or -1.  reverseG is
+// the transpose of G (see csrgraph::reversed), or G itself if G is
+// symmetric.
+//
+// delta is the bucket width (<= 0 means DefaultDelta) and numThreads the
+// # of threads (<= 0 means one per core).
+//
+// The distances are the same floating point values Dijkstra computes.
+// When a vertex can be reached along several equally short paths, its
+// predecessor is the one Dijkstra would pick: the candidate it settles
+// first, i.e. the smallest (distance, index).  That is exact as long as
+// edge weights are positive; across zero-weight edges the predecessors
+// still form a shortest path tree but may be a different one.
+//
+template<typename VertexT>
+vector<VertexT> DeltaStepping(const csrgraph<VertexT, double> &G,
+const csrgraph<VertexT, double> &reverseG, VertexT startV,
+vector<double> &distances, vector<int> &predecessors,
+double delta = 0, int numThreads = 0) {
+	struct Request {
+		int Vertex;
+		double Distance;
+		int Predecessor;
+	};
+
+	const long long NONE = numeric_limits<long long>::max();
+	int n = G.NumVertices();
+	int startIndex = G.indexOf(startV);
+	vector<VertexT> visited;
+
+	distances.assign(n, INF);
+	predecessors.assign(n, -1);
+
+	if (startIndex < 0) {
+		return visited;
+	}
+
+	if (!(delta > 0)) {
+		delta = DefaultDelta(G);
+	}
+
+	if (numThreads <= 0) {
+		numThreads = defaultThreadCount();
+	}
+
+	int T = numThreads;
+
+	// Outbox[from][to] = requests thread "from" mailed to thread "to"
+	vector<vector<vector<Request>>> Outbox(T, vector<vector<Request>>(T));
+	// Buckets[owner][b] = owned vertices whose distance was in bucket b
+	vector<vector<vector<int>>> Buckets(T);
+	vector<char> MoreLight(T);      // Light phase: current bucket refilled?
+	vector<long long> NextBucket(T);  // Smallest nonempty bucket per thread
+	Barrier barrier(T);
+
+	distances[startIndex] = 0;
+	Buckets[startIndex % T].resize(1);
+	Buckets[startIndex % T][0].push_back(startIndex);
+
+	auto bucketOf = [delta](double distance) {
+		return (long long) (distance / delta);
+	};
+
+	runTeam(T, [&](int t) {
+		vector<vector<int>> &buckets = Buckets[t];
+		vector<int> frontier;
+		vector<int> expanded;  // Vertices expanded in the current bucket
+		long long current = 0;
+
+		// Requests for vertex v go to its owner, if they improve on it
+		auto mail = [&](int u, int e, const csrgraph<VertexT, double> &side) {
+			int v = side.edgeTarget(e);
+			double distance = distances[u] + side.edgeWeight(e);
+
+			if (distance < distances[v]) {
+				Outbox[t][v % T].push_back(Request{v, distance, u});
+			}
+		};
+
+		// Applies the requests mailed to this thread
+		auto deliver = [&]() {
+			for (int from = 0; from < T; from++) {
+				for (const Request &request : Outbox[from][t]) {
+					if (request.Distance < distances[request.Vertex]) {
+						long long b = bucketOf(request.Distance);
+
+						distances[request.Vertex] = request.Distance;
+						predecessors[request.Vertex] = request.Predecessor;
+
+						if ((long long) buckets.size() <= b) {
+							buckets.resize(b + 1);
+						}
+
+						buckets[b].push_back(request.Vertex);
+					}
+				}
+
+				Outbox[from][t].clear();
+			}
+		};
+
+		while (true) {
+			///////////////////////////////////////////////////////////
+			// Light edges, until the current bucket stays empty    //
+			///////////////////////////////////////////////////////////
+
+			while (true) {
+				frontier.clear();
+
+				if (current < (long long) buckets.size()) {
+					swap(frontier, buckets[current]);
+				}
+
+				// Skip duplicates and vertices that have since moved on
+				sort(frontier.begin(), frontier.end());
+				frontier.erase(unique(frontier.begin(), frontier.end()), frontier.end());
+
+				for (int u : frontier) {
+					if (bucketOf(distances[u]) != current) {
+						continue;
+					}
+
+					expanded.push_back(u);
+
+					for (int e = G.edgesBegin(u); e < G.edgesEnd(u); e++) {
+						if (G.edgeWeight(e) <= delta) {
+							mail(u, e, G);
+						}
+					}
+				}
+
+				barrier.wait();
+				deliver();
+				MoreLight[t] = current < (long long) buckets.size() && !buckets[current].empty();
+				barrier.wait();
+
+				bool more = false;
+
+				for (int i = 0; i < T; i++) {
+					more = more || MoreLight[i];
+				}
+
+				if (!more) {
+					break;
+				}
+			}
+
+			///////////////////////////////////////////
+			// Heavy edges of everything expanded    //
+			///////////////////////////////////////////
+
+			sort(expanded.begin(), expanded.end());
+			expanded.erase(unique(expanded.begin(), expanded.end()), expanded.end());
+
+			for (int u : expanded) {
+				for (int e = G.edgesBegin(u); e < G.edgesEnd(u); e++) {
+					if (G.edgeWeight(e) > delta) {
+						mail(u, e, G);
+					}
+				}
+			}
+
+			expanded.clear();
+
+			barrier.wait();
+			deliver();
+
+			/////////////////////////////////////////////////
+			// Move on to the smallest nonempty bucket     //
+			/////////////////////////////////////////////////
+
+			NextBucket[t] = NONE;
+
+			for (long long b = current; b < (long long) buckets.size(); b++) {
+				if (!buckets[b].empty()) {
+					NextBucket[t] = b;
+					break;
+				}
+			}
+
+			barrier.wait();
+
+			current = NONE;
+
+			for (int i = 0; i < T; i++) {
+				current = min(current, NextBucket[i]);
+			}
+
+			if (current == NONE) {
+				break;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Pick Dijkstra's predecessor: the smallest (distance, index) //
+		// among the neighbors a shortest path can come from           //
+		/////////////////////////////////////////////////////////////////
+
+		for (int v = t; v < n; v += T) {
+			if (distances[v] == INF || v == startIndex) {
+				continue;
+			}
+
+			int best = -1;
+
+			for (int e = reverseG.edgesBegin(v); e < reverseG.edgesEnd(v); e++) {
+				int u = reverseG.edgeTarget(e);
+
+				if (distances[u] < distances[v] &&
+				distances[u] + reverseG.edgeWeight(e) == distances[v] &&
+				(best == -1 || distances[u] < distances[best] ||
+				(distances[u] == distances[best] && u < best))) {
+					best = u;
+				}
+			}
+
+			// Otherwise only zero-weight edges lead here, keep the one found
+			if (best != -1) {
+				predecessors[v] = best;
+			}
+		}
+	});
+
+	///////////////////////////////////////////////////
+	// Visiting order: by distance, ties by index    //
+	///////////////////////////////////////////////////
+
+	vector<pair<double, int>> order;
+
+	for (int v = 0; v < n; v++) {
+		if (distances[v] != INF) {
+			order.push_back(make_pair(distances[v], v));
+		}
+	}
+
+	sort(order.begin(), order.end());
+
+	for (const pair<double, int> &entry : order) {
+		visited.push_back(G.vertexAt(entry.second));
+	}
+
+	return visited;
+}
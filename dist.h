@@ -6,6 +6,8 @@
 // Project #7 - Openstreen Maps
 // 
 
+#pragma once
+
 #include <iostream>
 #include <cmath>
 
@@ -0,0 +1,88 @@
+// footwaygraph.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Builds the walking graph from the nodes and footways read out of a map
+// (see osm.h): every node becomes a vertex, numbered 0..N-1 in ID order,
+// and every pair of consecutive footway nodes becomes an edge both ways,
+// weighted by DistanceMetric (see metrics.h).  application.cpp and
+// benchmark.cpp both build their graph here, so they always route on the
+// same one.
+//
+// Example:
+//    IDMapper mapper;
+//    vector<Coordinates> NodeCoords;
+//    graph<uint32_t, double> G;
+//    BuildFootwayGraph(Nodes, Footways, mapper, NodeCoords, G);
+//
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#include "graph.h"
+#include "idmap.h"
+#include "metrics.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// BuildFootwayGraph
+//
+// Adds every node of Nodes to mapper, NodeCoords (NodeCoords[index] is
+// the coordinates of node mapper.toID(index)) and G, then adds the
+// footway edges to G.  from / to get the indices of the two ends of every
+// footway segment, in footway order.  Throws out_of_range if a footway
+// names a node missing from Nodes.
+//
+inline void BuildFootwayGraph(const map<long long, Coordinates> &Nodes,
+const vector<FootwayInfo> &Footways, IDMapper &mapper, vector<Coordinates> &NodeCoords,
+graph<uint32_t, double> &G, vector<uint32_t> &from, vector<uint32_t> &to) {
+	vector<double> miles;
+
+	// Nodes is sorted by ID, so index order matches ID order
+	mapper.reserve(Nodes.size());
+	NodeCoords.reserve(Nodes.size());
+
+	for (const pair<const long long, Coordinates> &currPair : Nodes) {
+		uint32_t index = mapper.add(currPair.first);
+
+		NodeCoords.push_back(currPair.second);
+		G.addVertex(index);
+	}
+
+	// Collect the two subsequent nodes of each footway as a segment
+	for (const FootwayInfo &currFootway : Footways) {
+		for (int i = 0; i < (int) currFootway.Nodes.size() - 1; i++) {
+			from.push_back(mapper.toIndex(currFootway.Nodes[i]));
+			to.push_back(mapper.toIndex(currFootway.Nodes[i + 1]));
+		}
+	}
+
+	// Calculate the distances all at once, by default the same as
+	// distBetween2Points
+	MetricDistances<DistanceMetric>(NodeCoords, from, to, miles);
+
+	for (size_t i = 0; i < from.size(); i++) {
+		// Add edge both ways
+		G.addEdge(from[i], to[i], miles[i]);
+		G.addEdge(to[i], from[i], miles[i]);
+	}
+}
+
+//
+// Same, for callers that do not need the segment ends.
+//
+inline void BuildFootwayGraph(const map<long long, Coordinates> &Nodes,
+const vector<FootwayInfo> &Footways, IDMapper &mapper, vector<Coordinates> &NodeCoords,
+graph<uint32_t, double> &G) {
+	vector<uint32_t> from, to;
+
+	BuildFootwayGraph(Nodes, Footways, mapper, NodeCoords, G, from, to);
+}
@@ -247,6 +247,29 @@ class graph {
 		return S;
 	}
 
+	//
+	// forEachNeighbor
+	//
+	// Calls visit(neighbor, weight) for every edge (v, neighbor, weight),
+	// in the same sorted order as neighbors().  Unlike neighbors(), nothing
+	// is copied or allocated, and no getWeight() lookup is needed afterwards.
+	//
+	// Example:
+	//    G.forEachNeighbor(v, [&](const VertexT& n, const WeightT& w) {
+	//        ...
+	//    });
+	//
+	template<typename VisitorT>
+	void forEachNeighbor(VertexT v, VisitorT visit) const {
+		myConstMapIterator fromVertexAndMapPair = AdjList.find(v);
+
+		if (fromVertexAndMapPair != AdjList.end()) {
+			for (const auto &neighborAndWeightPair : fromVertexAndMapPair->second) {
+				visit(neighborAndWeightPair.first, neighborAndWeightPair.second);
+			}
+		}
+	}
+
 	//
 	// getVertices
 	//
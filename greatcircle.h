@@ -0,0 +1,232 @@
+// greatcircle.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// GreatCirclePoints computes many great circle distances at once: from
+// one point to every stored point, or between many pairs of stored
+// points (e.g. the two ends of every footway segment).
+//
+// distBetween2Points does the degrees to radians conversion and eight
+// sin / cos calls for every pair.  Node coordinates never change, so here
+// the sines and cosines are worked out once per point and kept as
+// separate arrays (structure of arrays), which lets the products and sums
+// run several points per instruction: 2 with SSE2, which every x86-64
+// compiler uses by default, or 4 when built with AVX (e.g. -mavx2 or
+// -march=native).  Other machines take a plain loop.  The acos at the end
+// is still one call per distance.
+//
+// Every distance is bit for bit the one distBetween2Points returns for
+// the same two points in the same order: the trig values come from the
+// same radians and the products and sums are done in the same order.
+// TrigCoordinates (trigcoords.h) keeps the same values one node at a
+// time, for lookups that are not batched.
+//
+// Example:
+//    GreatCirclePoints points(NodeCoords);
+//    vector<double> miles;
+//    points.distancesBetween(from, to, miles);  // miles[i] for from[i] -> to[i]
+//
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "trigcoords.h"
+#include "osm.h"
+
+using namespace std;
+
+class GreatCirclePoints {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	// [i] = sin / cos of point i's latitude and longitude
+	vector<double> SinLat;
+	vector<double> CosLat;
+	vector<double> SinLon;
+	vector<double> CosLon;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// toMiles
+	//
+	// Turns dot products of unit vectors into distances, in place.
+	//
+	static void toMiles(double *dots, int n) {
+		for (int i = 0; i < n; i++) {
+			dots[i] = EarthRadiusMiles * acos(dots[i]);
+		}
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	GreatCirclePoints() {
+	}
+
+	//
+	// One point per element of coords, in the same order.
+	//
+	explicit GreatCirclePoints(const vector<Coordinates> &coords) {
+		SinLat.resize(coords.size());
+		CosLat.resize(coords.size());
+		SinLon.resize(coords.size());
+		CosLon.resize(coords.size());
+
+		for (size_t i = 0; i < coords.size(); i++) {
+			double latRad = coords[i].Lat * TrigPI / 180.0;
+			double lonRad = coords[i].Lon * TrigPI / 180.0;
+
+			SinLat[i] = sin(latRad);
+			CosLat[i] = cos(latRad);
+			SinLon[i] = sin(lonRad);
+			CosLon[i] = cos(lonRad);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumPoints() const {
+		return (int) SinLat.size();
+	}
+
+	//
+	// distancesFrom
+	//
+	// miles[i] = distBetween2Points(lat, lon, point i) for every point.
+	//
+	void distancesFrom(double lat, double lon, vector<double> &miles) const {
+		int n = NumPoints();
+		int i = 0;
+		double latRad = lat * TrigPI / 180.0;
+		double lonRad = lon * TrigPI / 180.0;
+
+		// The first point's factors, as distBetween2Points multiplies them
+		double x = cos(latRad) * cos(lonRad);
+		double y = cos(latRad) * sin(lonRad);
+		double z = sin(latRad);
+
+		miles.resize(n);
+
+#if defined(__AVX__)
+		__m256d x4 = _mm256_set1_pd(x);
+		__m256d y4 = _mm256_set1_pd(y);
+		__m256d z4 = _mm256_set1_pd(z);
+
+		for (; i + 4 <= n; i += 4) {
+			__m256d cosLat = _mm256_loadu_pd(&CosLat[i]);
+			__m256d xx = _mm256_mul_pd(_mm256_mul_pd(x4, cosLat), _mm256_loadu_pd(&CosLon[i]));
+			__m256d yy = _mm256_mul_pd(_mm256_mul_pd(y4, cosLat), _mm256_loadu_pd(&SinLon[i]));
+			__m256d zz = _mm256_mul_pd(z4, _mm256_loadu_pd(&SinLat[i]));
+
+			_mm256_storeu_pd(&miles[i], _mm256_add_pd(_mm256_add_pd(xx, yy), zz));
+		}
+#elif defined(__SSE2__)
+		__m128d x2 = _mm_set1_pd(x);
+		__m128d y2 = _mm_set1_pd(y);
+		__m128d z2 = _mm_set1_pd(z);
+
+		for (; i + 2 <= n; i += 2) {
+			__m128d cosLat = _mm_loadu_pd(&CosLat[i]);
+			__m128d xx = _mm_mul_pd(_mm_mul_pd(x2, cosLat), _mm_loadu_pd(&CosLon[i]));
+			__m128d yy = _mm_mul_pd(_mm_mul_pd(y2, cosLat), _mm_loadu_pd(&SinLon[i]));
+			__m128d zz = _mm_mul_pd(z2, _mm_loadu_pd(&SinLat[i]));
+
+			_mm_storeu_pd(&miles[i], _mm_add_pd(_mm_add_pd(xx, yy), zz));
+		}
+#endif
+
+		// What is left over, one at a time
+		for (; i < n; i++) {
+			miles[i] = x * CosLat[i] * CosLon[i] + y * CosLat[i] * SinLon[i] + z * SinLat[i];
+		}
+
+		toMiles(miles.data(), n);
+	}
+
+	void distancesFrom(const Coordinates &point, vector<double> &miles) const {
+		distancesFrom(point.Lat, point.Lon, miles);
+	}
+
+	//
+	// distancesBetween
+	//
+	// miles[i] = distBetween2Points(point from[i], point to[i]) for every
+	// i; from and to must be the same size.
+	//
+	void distancesBetween(const vector<uint32_t> &from, const vector<uint32_t> &to,
+	vector<double> &miles) const {
+		int n = (int) from.size();
+		int i = 0;
+
+		miles.resize(n);
+
+#if defined(__AVX__)
+		for (; i + 4 <= n; i += 4) {
+			const uint32_t *a = &from[i];
+			const uint32_t *b = &to[i];
+			__m256d cosLatA = _mm256_set_pd(CosLat[a[3]], CosLat[a[2]], CosLat[a[1]], CosLat[a[0]]);
+			__m256d cosLatB = _mm256_set_pd(CosLat[b[3]], CosLat[b[2]], CosLat[b[1]], CosLat[b[0]]);
+			__m256d xx = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(cosLatA,
+			_mm256_set_pd(CosLon[a[3]], CosLon[a[2]], CosLon[a[1]], CosLon[a[0]])), cosLatB),
+			_mm256_set_pd(CosLon[b[3]], CosLon[b[2]], CosLon[b[1]], CosLon[b[0]]));
+			__m256d yy = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(cosLatA,
+			_mm256_set_pd(SinLon[a[3]], SinLon[a[2]], SinLon[a[1]], SinLon[a[0]])), cosLatB),
+			_mm256_set_pd(SinLon[b[3]], SinLon[b[2]], SinLon[b[1]], SinLon[b[0]]));
+			__m256d zz = _mm256_mul_pd(
+			_mm256_set_pd(SinLat[a[3]], SinLat[a[2]], SinLat[a[1]], SinLat[a[0]]),
+			_mm256_set_pd(SinLat[b[3]], SinLat[b[2]], SinLat[b[1]], SinLat[b[0]]));
+
+			_mm256_storeu_pd(&miles[i], _mm256_add_pd(_mm256_add_pd(xx, yy), zz));
+		}
+#elif defined(__SSE2__)
+		for (; i + 2 <= n; i += 2) {
+			const uint32_t *a = &from[i];
+			const uint32_t *b = &to[i];
+			__m128d cosLatA = _mm_set_pd(CosLat[a[1]], CosLat[a[0]]);
+			__m128d cosLatB = _mm_set_pd(CosLat[b[1]], CosLat[b[0]]);
+			__m128d xx = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(cosLatA,
+			_mm_set_pd(CosLon[a[1]], CosLon[a[0]])), cosLatB),
+			_mm_set_pd(CosLon[b[1]], CosLon[b[0]]));
+			__m128d yy = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(cosLatA,
+			_mm_set_pd(SinLon[a[1]], SinLon[a[0]])), cosLatB),
+			_mm_set_pd(SinLon[b[1]], SinLon[b[0]]));
+			__m128d zz = _mm_mul_pd(_mm_set_pd(SinLat[a[1]], SinLat[a[0]]),
+			_mm_set_pd(SinLat[b[1]], SinLat[b[0]]));
+
+			_mm_storeu_pd(&miles[i], _mm_add_pd(_mm_add_pd(xx, yy), zz));
+		}
+#endif
+
+		for (; i < n; i++) {
+			uint32_t a = from[i];
+			uint32_t b = to[i];
+
+			miles[i] = CosLat[a] * CosLon[a] * CosLat[b] * CosLon[b]
+			+ CosLat[a] * SinLon[a] * CosLat[b] * SinLon[b]
+			+ SinLat[a] * SinLat[b];
+		}
+
+		toMiles(miles.data(), n);
+	}
+};
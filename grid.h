@@ -0,0 +1,276 @@
+// grid.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// FootwayGrid finds the footway node nearest to a point (e.g. a building)
+// with a flat grid of buckets over the map.
+//
+// The map's bounding box is cut into equal latitude / longitude cells,
+// sized so that each holds about NodesPerCell nodes on average, and every
+// node is filed under its cell with one counting sort.  Building the grid
+// is a couple of passes over the nodes, so it is ready as soon as the
+// footways are read.
+//
+// A query starts at the cell the point falls in and looks at rings of
+// cells around it, one ring further out at a time.  Once every cell not
+// yet visited is certainly farther than the best node found, it stops.
+// Like FootwayKdTree, it returns exactly what the old linear scan did
+// (see spatial.h).
+//
+// Example:
+//    FootwayGrid footwayIndex(Footways, mapper, NodeCoords);
+//    uint32_t nearest = footwayIndex.nearest(building.Coords);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "spatial.h"
+
+using namespace std;
+
+class FootwayGrid {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	// Average # of nodes per cell the grid is sized for
+	static const int NodesPerCell = 2;
+
+	int nRows;  // Cells along the latitude
+	int nCols;  // Cells along the longitude
+	double MinLat, MinLon;
+	double CellLat, CellLon;  // Cell size in degrees
+	double MaxAbsLat;         // Of any node, for the longitude bound
+
+	// Nodes sorted by cell: cell c holds Points[CellStart[c], CellStart[c + 1])
+	vector<FootwayPoint> Points;
+	vector<int> CellStart;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int rowOf(double lat) const {
+		return (int) min(max(floor((lat - MinLat) / CellLat), 0.0), (double) nRows - 1);
+	}
+
+	int colOf(double lon) const {
+		return (int) min(max(floor((lon - MinLon) / CellLon), 0.0), (double) nCols - 1);
+	}
+
+	//
+	// scanCell
+	//
+	// Offers every node of cell (row, col) to best, if the cell exists.
+	//
+	void scanCell(int row, int col, NearestFootwayPoint &best) const {
+		if (row < 0 || row >= nRows || col < 0 || col >= nCols) {
+			return;
+		}
+
+		int cell = row * nCols + col;
+
+		for (int i = CellStart[cell]; i < CellStart[cell + 1]; i++) {
+			best.consider(Points[i]);
+		}
+	}
+
+	//
+	// outsideBound
+	//
+	// Lower bound on the squared chord distance from best's query to any
+	// node outside rows [row - ring, row + ring] x cols [col - ring, col +
+	// ring], or INFINITY if that covers the whole grid.
+	//
+	double outsideBound(int row, int col, int ring, const NearestFootwayPoint &best) const {
+		const double toRadians = TrigPI / 180.0;
+		double degrees = INFINITY;  // Smallest latitude gap to an unvisited row
+		double bound = INFINITY;
+
+		if (row - ring > 0) {
+			degrees = min(degrees, best.Lat - (MinLat + (row - ring) * CellLat));
+		}
+
+		if (row + ring < nRows - 1) {
+			degrees = min(degrees, MinLat + (row + ring + 1) * CellLat - best.Lat);
+		}
+
+		// Points a latitude gap apart are at least that angle apart
+		if (degrees != INFINITY) {
+			double half = sin(max(degrees, 0.0) * toRadians / 2);
+
+			bound = 4 * half * half;
+		}
+
+		degrees = INFINITY;  // Smallest longitude gap to an unvisited column
+
+		if (col - ring > 0) {
+			degrees = min(degrees, best.Lon - (MinLon + (col - ring) * CellLon));
+		}
+
+		if (col + ring < nCols - 1) {
+			degrees = min(degrees, MinLon + (col + ring + 1) * CellLon - best.Lon);
+		}
+
+		// Chord^2 >= 4 cos(lat1) cos(lat2) sin^2(lon gap / 2), as long as
+		// the gap cannot wrap around the globe
+		if (degrees != INFINITY) {
+			double half = (degrees > 90) ? 0 : sin(max(degrees, 0.0) * toRadians / 2);
+			double cosLat = min(cos(best.Lat * toRadians), cos(MaxAbsLat * toRadians));
+
+			bound = min(bound, 4 * max(cosLat, 0.0) * max(cosLat, 0.0) * half * half);
+		}
+
+		return bound;
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	FootwayGrid() {
+		nRows = 0;
+		nCols = 0;
+		MinLat = MinLon = 0;
+		CellLat = CellLon = 1;
+		MaxAbsLat = 0;
+	}
+
+	//
+	// Indexes every node of every footway.  mapper translates the node IDs
+	// into indices of NodeCoords.
+	//
+	FootwayGrid(const vector<FootwayInfo> &Footways, const IDMapper &mapper,
+	const vector<Coordinates> &NodeCoords)
+		: FootwayGrid() {
+		vector<FootwayPoint> points = FootwayPoints(Footways, mapper, NodeCoords);
+
+		if (points.empty()) {
+			return;
+		}
+
+		////////////////////////////////////////////////////////////
+		// Size the cells from the bounding box and node density //
+		////////////////////////////////////////////////////////////
+
+		double maxLat = points[0].Lat;
+		double maxLon = points[0].Lon;
+
+		MinLat = points[0].Lat;
+		MinLon = points[0].Lon;
+
+		for (const FootwayPoint &point : points) {
+			MinLat = min(MinLat, point.Lat);
+			MinLon = min(MinLon, point.Lon);
+			maxLat = max(maxLat, point.Lat);
+			maxLon = max(maxLon, point.Lon);
+			MaxAbsLat = max(MaxAbsLat, fabs(point.Lat));
+		}
+
+		// Cells roughly square on the ground
+		double height = maxLat - MinLat;
+		double width = (maxLon - MinLon) * max(cos((MinLat + maxLat) / 2 * TrigPI / 180.0), 0.01);
+		double numCells = max(1.0, (double) points.size() / NodesPerCell);
+		double side = sqrt(max(height * width, 1e-18) / numCells);
+
+		nRows = (int) min(max(ceil(height / side), 1.0), numCells);
+		nCols = (int) min(max(ceil(width / side), 1.0), numCells);
+		CellLat = max(height / nRows, 1e-12);
+		CellLon = max((maxLon - MinLon) / nCols, 1e-12);
+
+		//////////////////////////////////////
+		// File the nodes by counting sort //
+		//////////////////////////////////////
+
+		CellStart.assign(nRows * nCols + 1, 0);
+
+		for (const FootwayPoint &point : points) {
+			CellStart[rowOf(point.Lat) * nCols + colOf(point.Lon) + 1]++;
+		}
+
+		for (int c = 0; c < nRows * nCols; c++) {
+			CellStart[c + 1] += CellStart[c];
+		}
+
+		vector<int> next(CellStart.begin(), CellStart.end() - 1);
+
+		Points.resize(points.size());
+
+		for (const FootwayPoint &point : points) {
+			Points[next[rowOf(point.Lat) * nCols + colOf(point.Lon)]++] = point;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumPoints() const {
+		return (int) Points.size();
+	}
+
+	int NumRows() const {
+		return nRows;
+	}
+
+	int NumCols() const {
+		return nCols;
+	}
+
+	//
+	// nearest
+	//
+	// Index of the footway node closest to (lat, lon) by
+	// distBetween2Points, the first one in footway order on ties.  Returns
+	// NO_INDEX if there are no footway nodes.
+	//
+	uint32_t nearest(double lat, double lon) const {
+		NearestFootwayPoint best(lat, lon);
+
+		if (Points.empty()) {
+			return NO_INDEX;
+		}
+
+		// Points outside the map start from the nearest edge cell
+		int row = rowOf(lat);
+		int col = colOf(lon);
+
+		for (int ring = 0; ; ring++) {
+			// Top and bottom rows of the ring, then the sides between them
+			for (int c = col - ring; c <= col + ring; c++) {
+				scanCell(row - ring, c, best);
+
+				if (ring > 0) {
+					scanCell(row + ring, c, best);
+				}
+			}
+
+			for (int r = row - ring + 1; r <= row + ring - 1; r++) {
+				scanCell(r, col - ring, best);
+				scanCell(r, col + ring, best);
+			}
+
+			double bound = outsideBound(row, col, ring, best);
+
+			if (bound == INFINITY || !best.canBeat(bound)) {
+				break;
+			}
+		}
+
+		return best.index();
+	}
+
+	uint32_t nearest(const Coordinates &point) const {
+		return nearest(point.Lat, point.Lon);
+	}
+};
@@ -0,0 +1,93 @@
+// heuristics.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Lower bounds on the remaining distance to a destination, used to guide
+// AStarPath (see algs.h) toward it.  A heuristic is bound to one
+// destination and called with a graph index:
+//
+//    double remaining = heuristic(index);
+//
+// and must never return more than the true shortest distance from index
+// to the destination, otherwise A* may return a longer path.
+//
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "trigcoords.h"
+#include "metrics.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// MetricHeuristic
+//
+// Straight-line distance in miles from a node to the destination, by the
+// same metric as the edge weights (see metrics.h).  Every footway edge
+// weight is the distance between its two nodes, so no path can be
+// shorter than the straight line between its ends.
+//
+// nodePoints[index] must be the coordinates of graph index "index",
+// already converted for MetricT; the dense node indices from idmap.h are
+// used for both in application.cpp.  NodePointsT is
+// MetricCoordinates<MetricT>, or anything else indexed the same way.
+//
+template<typename MetricT, typename NodePointsT = MetricCoordinates<MetricT>>
+class MetricHeuristic {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	const NodePointsT *NodePoints;  // [index] = coordinates
+	typename MetricT::Point Dest;
+
+	public:
+	//
+	// Slack
+	//
+	// The law of cosines takes an acos() of a value very close to 1, so
+	// a distance can be off by up to about 1e-4 miles (16 cm) for points
+	// that nearly coincide, and about 1e-6 miles (1.6 mm) for points 10 m
+	// apart; edges of a few centimeters often round to 0.  The edge
+	// weights carry the same error and it adds up along a path, so the
+	// bound is lowered by this much (~1.6 m): its own error plus that of
+	// several worst-case edges.  The flat equirectangular distances need
+	// some too, as they bend the triangle inequality by a hair.
+	//
+	static constexpr double Slack = 1e-3;
+
+	MetricHeuristic(const NodePointsT &nodePoints,
+	                const Coordinates &dest) {
+		this->NodePoints = &nodePoints;
+		this->Dest = MetricT::point(dest);
+	}
+
+	double operator()(int index) const {
+		double remaining = MetricT::miles((*NodePoints)[index], Dest) - Slack;
+
+		// acos() can return NaN for (nearly) identical points
+		if (!(remaining > 0)) {
+			return 0;
+		}
+
+		return remaining;
+	}
+};
+
+//
+// GreatCircleHeuristic
+//
+// MetricHeuristic for distBetween2Points' great circle distance, over
+// the sines and cosines kept in a TrigCoordinates (trigcoords.h).  Each
+// call costs a single acos, yet returns exactly what distBetween2Points
+// would.
+//
+typedef MetricHeuristic<LawOfCosinesMetric, TrigCoordinates> GreatCircleHeuristic;
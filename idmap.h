@@ -0,0 +1,117 @@
+// idmap.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Bidirectional mapping between 64-bit OpenStreetMap node IDs and compact
+// indices 0..N-1.  Indices are handed out in the order IDs are added, so the
+// rest of the program can keep per-node data in plain vectors indexed by
+// uint32_t and only translate back to OSM IDs when printing.
+//
+// Example:
+//    IDMapper mapper;
+//    uint32_t index = mapper.add(462010732);  // index == 0
+//    mapper.toID(index);                      // 462010732
+//
+
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+// Invalid index, used where the old code stored -1 (e.g. "no predecessor")
+const uint32_t NO_INDEX = numeric_limits<uint32_t>::max();
+
+class IDMapper {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	unordered_map<long long, uint32_t> IndexOf;  // <OSM ID, index>
+	vector<long long> IDs;                       // IDs[index] == OSM ID
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// add
+	//
+	// Returns the index assigned to id, handing out the next free index
+	// if id has not been seen before.
+	//
+	uint32_t add(long long id) {
+		unordered_map<long long, uint32_t>::const_iterator found = IndexOf.find(id);
+
+		if (found != IndexOf.end()) {
+			return found->second;
+		}
+
+		if (IDs.size() >= (size_t) NO_INDEX) {
+			throw length_error("IDMapper: out of indices");
+		}
+
+		uint32_t index = (uint32_t) IDs.size();
+
+		IndexOf.emplace(id, index);
+		IDs.push_back(id);
+
+		return index;
+	}
+
+	//
+	// reserve
+	//
+	// Pre-allocates room for n IDs so add() does not rehash while loading.
+	//
+	void reserve(size_t n) {
+		IndexOf.reserve(n);
+		IDs.reserve(n);
+	}
+
+	//
+	// contains
+	//
+	// Returns true if id has been assigned an index.
+	//
+	bool contains(long long id) const {
+		return IndexOf.find(id) != IndexOf.end();
+	}
+
+	//
+	// toIndex
+	//
+	// Returns the index of id.  Throws out_of_range if id was never
+	// added, the same way map::at() does.
+	//
+	uint32_t toIndex(long long id) const {
+		return IndexOf.at(id);
+	}
+
+	//
+	// toID
+	//
+	// Returns the OSM ID stored at index.
+	//
+	long long toID(uint32_t index) const {
+		return IDs.at(index);
+	}
+
+	//
+	// size
+	//
+	// Returns the # of IDs that have been assigned an index.
+	//
+	uint32_t size() const {
+		return (uint32_t) IDs.size();
+	}
+};
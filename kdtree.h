@@ -0,0 +1,167 @@
+// kdtree.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// FootwayKdTree finds the footway node nearest to a point (e.g. a
+// building) without looking at every node of every footway.
+//
+// The nodes are placed on the unit sphere (see spatial.h), where the
+// straight line distance between two points grows with the distance along
+// the earth.  A k-d tree over those points then finds the nearest node in
+// about log(N) steps: it descends to the region around the query and only
+// crosses a splitting plane when the plane is closer than the best node
+// found so far.  The answer is exactly the one the old linear scan gave.
+//
+// Example:
+//    FootwayKdTree footwayIndex(Footways, mapper, NodeCoords);
+//    uint32_t nearest = footwayIndex.nearest(building.Coords);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "spatial.h"
+
+using namespace std;
+
+class FootwayKdTree {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	// Implicit tree: the node of range [lo, hi) is Points[(lo + hi) / 2],
+	// its children the ranges on either side.  SplitAxis[i] is the axis
+	// Points[i] splits on.
+	vector<FootwayPoint> Points;
+	vector<unsigned char> SplitAxis;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// build
+	//
+	// Arranges Points[lo, hi) into a subtree, splitting on the axis along
+	// which the points are most spread out.
+	//
+	void build(int lo, int hi) {
+		if (hi - lo <= 0) {
+			return;
+		}
+
+		int mid = (lo + hi) / 2;
+		int axis = 0;
+		double widest = -1;
+
+		for (int a = 0; a < 3; a++) {
+			double low = INFINITY;
+			double high = -INFINITY;
+
+			for (int i = lo; i < hi; i++) {
+				low = min(low, Points[i].Axis[a]);
+				high = max(high, Points[i].Axis[a]);
+			}
+
+			if (high - low > widest) {
+				widest = high - low;
+				axis = a;
+			}
+		}
+
+		nth_element(Points.begin() + lo, Points.begin() + mid, Points.begin() + hi,
+		[axis](const FootwayPoint &a, const FootwayPoint &b) { return a.Axis[axis] < b.Axis[axis]; });
+
+		SplitAxis[mid] = (unsigned char) axis;
+
+		build(lo, mid);
+		build(mid + 1, hi);
+	}
+
+	//
+	// search
+	//
+	// Offers every point of the subtree Points[lo, hi) that could still
+	// win to best.
+	//
+	void search(int lo, int hi, NearestFootwayPoint &best) const {
+		if (hi - lo <= 0) {
+			return;
+		}
+
+		int mid = (lo + hi) / 2;
+		int axis = SplitAxis[mid];
+		double gap = best.Query[axis] - Points[mid].Axis[axis];
+
+		best.consider(Points[mid]);
+
+		// Near side first, then the far side if the plane is close enough
+		if (gap < 0) {
+			search(lo, mid, best);
+
+			if (best.canBeat(gap * gap)) {
+				search(mid + 1, hi, best);
+			}
+		} else {
+			search(mid + 1, hi, best);
+
+			if (best.canBeat(gap * gap)) {
+				search(lo, mid, best);
+			}
+		}
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	FootwayKdTree() {
+	}
+
+	//
+	// Indexes every node of every footway.  mapper translates the node IDs
+	// into indices of NodeCoords.
+	//
+	FootwayKdTree(const vector<FootwayInfo> &Footways, const IDMapper &mapper,
+	const vector<Coordinates> &NodeCoords) {
+		Points = FootwayPoints(Footways, mapper, NodeCoords);
+		SplitAxis.assign(Points.size(), 0);
+		build(0, (int) Points.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumPoints() const {
+		return (int) Points.size();
+	}
+
+	//
+	// nearest
+	//
+	// Index of the footway node closest to (lat, lon) by
+	// distBetween2Points, the first one in footway order on ties.  Returns
+	// NO_INDEX if there are no footway nodes.
+	//
+	uint32_t nearest(double lat, double lon) const {
+		NearestFootwayPoint best(lat, lon);
+
+		search(0, (int) Points.size(), best);
+
+		return best.index();
+	}
+
+	uint32_t nearest(const Coordinates &point) const {
+		return nearest(point.Lat, point.Lon);
+	}
+};
@@ -0,0 +1,327 @@
+// matrix.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Many-to-many distance tables, e.g. every building against every other.
+//
+// ComputeDistanceMatrix fills an S x T table of shortest distances either
+// with one Dijkstra per source, spread over a work-stealing scheduler (see
+// scheduler.h), or, when a contraction hierarchy is available, with its
+// bucket method (see ContractionHierarchy::manyToMany in ch.h), which is
+// much faster for large tables.
+//
+// Example:
+//    DistanceMatrix table = ComputeDistanceMatrix(CG, nodes, nodes, &scheduler);
+//    table.setLabels(names, names);
+//    table.writeCSV("buildings.csv");
+//
+
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+#include "csrgraph.h"
+#include "algs.h"
+#include "ch.h"
+#include "scheduler.h"
+
+using namespace std;
+
+class DistanceMatrix {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	int nRows;
+	int nCols;
+	vector<double> Values;  // Row-major, [row * nCols + col], INF if unreachable
+	vector<string> RowLabels;
+	vector<string> ColLabels;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// csvField
+	//
+	// Quotes a label if it contains a comma, quote or line break.
+	//
+	static string csvField(const string &text) {
+		if (text.find_first_of(",\"\r\n") == string::npos) {
+			return text;
+		}
+
+		string quoted = "\"";
+
+		for (char c : text) {
+			quoted += c;
+
+			if (c == '"') {
+				quoted += '"';
+			}
+		}
+
+		return quoted + "\"";
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	DistanceMatrix() {
+		nRows = 0;
+		nCols = 0;
+	}
+
+	//
+	// rows x cols table with every entry INF.
+	//
+	DistanceMatrix(int rows, int cols) {
+		nRows = rows;
+		nCols = cols;
+		Values.assign((size_t) rows * cols, INF);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumRows() const {
+		return nRows;
+	}
+
+	int NumCols() const {
+		return nCols;
+	}
+
+	double& at(int row, int col) {
+		return Values[(size_t) row * nCols + col];
+	}
+
+	double at(int row, int col) const {
+		return Values[(size_t) row * nCols + col];
+	}
+
+	//
+	// row
+	//
+	// Pointer to the nCols entries of a row.
+	//
+	double* row(int r) {
+		return &Values[(size_t) r * nCols];
+	}
+
+	//
+	// setLabels
+	//
+	// Names of the rows and columns, written out by writeCSV.  Either may
+	// be empty, otherwise they must have NumRows() / NumCols() entries.
+	//
+	void setLabels(const vector<string> &rowLabels, const vector<string> &colLabels) {
+		RowLabels = rowLabels;
+		ColLabels = colLabels;
+	}
+
+	//
+	// writeCSV
+	//
+	// Writes the table as comma separated values, one row per line, with
+	// the labels (if any) as the first row and column.  Distances are in
+	// miles with enough digits to read back the exact double; unreachable
+	// entries are written as "inf".  Returns false if the file could not
+	// be written.
+	//
+	bool writeCSV(const string &filename) const {
+		ofstream file(filename);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		file << setprecision(numeric_limits<double>::max_digits10);
+
+		if (!ColLabels.empty()) {
+			if (!RowLabels.empty()) {
+				file << ",";
+			}
+
+			for (int c = 0; c < nCols; c++) {
+				file << (c > 0 ? "," : "") << csvField(ColLabels[c]);
+			}
+
+			file << "\n";
+		}
+
+		for (int r = 0; r < nRows; r++) {
+			if (!RowLabels.empty()) {
+				file << csvField(RowLabels[r]) << ",";
+			}
+
+			for (int c = 0; c < nCols; c++) {
+				if (c > 0) {
+					file << ",";
+				}
+
+				if (at(r, c) == INF) {
+					file << "inf";
+				} else {
+					file << at(r, c);
+				}
+			}
+
+			file << "\n";
+		}
+
+		return file.good();
+	}
+
+	//
+	// writeBinary / readBinary
+	//
+	// Dense binary form: the 4 bytes "DMX1", the # of rows and columns as
+	// 32-bit integers, then the rows * cols doubles row by row, all in the
+	// machine's byte order.  Unreachable entries are +infinity.  Labels are
+	// not stored.  Both return false on failure; readBinary then leaves
+	// this table unchanged.
+	//
+	bool writeBinary(const string &filename) const {
+		ofstream file(filename, ios::binary);
+
+		if (!file.good()) {
+			return false;
+		}
+
+		int32_t header[2] = { nRows, nCols };
+
+		file.write("DMX1", 4);
+		file.write((const char *) header, sizeof(header));
+
+		for (double value : Values) {
+			double stored = (value == INF) ? numeric_limits<double>::infinity() : value;
+
+			file.write((const char *) &stored, sizeof(stored));
+		}
+
+		return file.good();
+	}
+
+	bool readBinary(const string &filename) {
+		ifstream file(filename, ios::binary);
+		char magic[4];
+		int32_t header[2];
+
+		if (!file.read(magic, 4) || memcmp(magic, "DMX1", 4) != 0 ||
+		!file.read((char *) header, sizeof(header)) || header[0] < 0 || header[1] < 0) {
+			return false;
+		}
+
+		vector<double> values((size_t) header[0] * header[1]);
+
+		if (!file.read((char *) values.data(), values.size() * sizeof(double))) {
+			return false;
+		}
+
+		for (double &value : values) {
+			if (value == numeric_limits<double>::infinity()) {
+				value = INF;
+			}
+		}
+
+		nRows = header[0];
+		nCols = header[1];
+		Values.swap(values);
+		RowLabels.clear();
+		ColLabels.clear();
+
+		return true;
+	}
+};
+
+//
+// ComputeDistanceMatrix
+//
+// Shortest distances from every source to every target in G, one
+// Dijkstra per source.  The sources are spread over scheduler's workers if
+// one is given.  Entries are exactly what DijkstraPath returns; vertices
+// that are not in G get rows / columns of INF.
+//
+template<typename VertexT>
+DistanceMatrix ComputeDistanceMatrix(const csrgraph<VertexT, double> &G,
+const vector<VertexT> &sources, const vector<VertexT> &targets,
+WorkStealingScheduler *scheduler = nullptr) {
+	DistanceMatrix table((int) sources.size(), (int) targets.size());
+	vector<int> targetIndices;
+
+	for (const VertexT &target : targets) {
+		targetIndices.push_back(G.indexOf(target));
+	}
+
+	int numWorkers = (scheduler != nullptr) ? scheduler->NumWorkers() : 1;
+	vector<SearchWorkspace> workspaces(numWorkers);
+	vector<vector<int>> visited(numWorkers);
+
+	// Row i: one full search from sources[i], then read off the targets
+	auto fillRow = [&](size_t i, int worker) {
+		int source = G.indexOf(sources[i]);
+		double *row = table.row((int) i);
+
+		if (source < 0) {
+			return;
+		}
+
+		visited[worker].clear();
+		DijkstraSearch(G, source, -1, workspaces[worker], visited[worker]);
+
+		for (size_t j = 0; j < targetIndices.size(); j++) {
+			if (targetIndices[j] >= 0) {
+				row[j] = workspaces[worker].distance(targetIndices[j]);
+			}
+		}
+	};
+
+	if (scheduler != nullptr) {
+		scheduler->parallelFor(sources.size(), fillRow);
+	} else {
+		for (size_t i = 0; i < sources.size(); i++) {
+			fillRow(i, 0);
+		}
+	}
+
+	return table;
+}
+
+//
+// ComputeDistanceMatrix
+//
+// Same table from a contraction hierarchy built on G, by the bucket
+// method.  Entries can differ from DijkstraPath's in the last bits, see
+// ContractionHierarchy::manyToMany.
+//
+template<typename VertexT>
+DistanceMatrix ComputeDistanceMatrix(const csrgraph<VertexT, double> &G,
+const ContractionHierarchy<VertexT> &CH, const vector<VertexT> &sources,
+const vector<VertexT> &targets) {
+	DistanceMatrix table((int) sources.size(), (int) targets.size());
+	vector<double> values = CH.manyToMany(G, sources, targets);
+
+	for (size_t i = 0; i < sources.size(); i++) {
+		for (size_t j = 0; j < targets.size(); j++) {
+			table.at((int) i, (int) j) = values[i * targets.size() + j];
+		}
+	}
+
+	return table;
+}
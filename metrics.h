@@ -0,0 +1,304 @@
+// metrics.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Ways of measuring the distance between two (lat, lon) points, all with
+// the same interface so edge weights and A* bounds can be switched
+// together at compile time:
+//
+//    LawOfCosinesMetric   distBetween2Points (dist.cpp), the default.
+//                         Rounds to millimeters for nearby points.
+//    HaversineMetric      Same sphere, from the chord between the points;
+//                         stays accurate down to nanometers.
+//    EquirectangularMetric  Same sphere, flattened around the two points.
+//                         Just a square root, and well under a millimeter
+//                         off for points a campus apart.
+//    VincentyMetric       Along the WGS84 ellipsoid instead of a sphere;
+//                         the most accurate and the slowest.  About 0.3%
+//                         from the sphere ones, which use distBetween2Points'
+//                         earth radius.
+//
+// Each metric converts a point once into the form it works on (Point) and
+// then measures between two of those:
+//
+//    MetricT::Point a = MetricT::point(coordinates);
+//    double miles = MetricT::miles(a, b);
+//
+// DistanceMetric is the one the program uses; pick another when building,
+// e.g. g++ -DDISTANCE_METRIC=HaversineMetric ...  Anything other than the
+// default changes the distances printed a little.
+//
+// Example:
+//    MetricCoordinates<DistanceMetric> nodePoints(NodeCoords);
+//    double miles = nodePoints.miles(from, to);
+//
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#include "trigcoords.h"
+#include "greatcircle.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// LawOfCosinesMetric
+//
+// acos of the dot product of the unit vectors, bit for bit
+// distBetween2Points.
+//
+struct LawOfCosinesMetric {
+	typedef TrigPoint Point;
+
+	static const char* name() {
+		return "law of cosines";
+	}
+
+	static Point point(const Coordinates &coords) {
+		return TrigPoint(coords);
+	}
+
+	static double miles(const Point &a, const Point &b) {
+		return greatCircleMiles(a, b);
+	}
+};
+
+//
+// HaversineMetric
+//
+// 2 asin of half the chord, which is the haversine formula: half the
+// chord squared is sin^2(dLat / 2) + cos(lat1) cos(lat2) sin^2(dLon / 2).
+//
+struct HaversineMetric {
+	typedef TrigPoint Point;
+
+	static const char* name() {
+		return "haversine";
+	}
+
+	static Point point(const Coordinates &coords) {
+		return TrigPoint(coords);
+	}
+
+	static double miles(const Point &a, const Point &b) {
+		return chordMiles(a, b);
+	}
+};
+
+//
+// EquirectangularMetric
+//
+// Straight line on a flat map around the two points: a degree of
+// longitude is scaled by the cosine of the latitude between them (the
+// average of their cosines, which needs no trig per pair).  The error
+// grows with the cube of the distance: a few micrometers over a mile,
+// half a millimeter over eight.
+//
+struct EquirectangularMetric {
+	typedef TrigPoint Point;
+
+	static const char* name() {
+		return "equirectangular";
+	}
+
+	static Point point(const Coordinates &coords) {
+		return TrigPoint(coords);
+	}
+
+	static double miles(const Point &a, const Point &b) {
+		double dLon = b.LonRad - a.LonRad;
+
+		// The short way around, across the date line
+		if (dLon > TrigPI) {
+			dLon -= 2 * TrigPI;
+		} else if (dLon < -TrigPI) {
+			dLon += 2 * TrigPI;
+		}
+
+		double x = dLon * (a.CosLat + b.CosLat) / 2;
+		double y = b.LatRad - a.LatRad;
+
+		return EarthRadiusMiles * sqrt(x * x + y * y);
+	}
+};
+
+//
+// VincentyMetric
+//
+// Vincenty's inverse formula on the WGS84 ellipsoid, iterated until the
+// longitude on the auxiliary sphere settles to 1e-12 radians (far under
+// a millimeter).  For (nearly) opposite points of the earth, where it may
+// not converge, the last estimate after 100 rounds is returned.
+//
+struct VincentyMetric {
+	struct Point {
+		double LonRad;
+		double SinU;  // U = reduced latitude
+		double CosU;
+	};
+
+	static const char* name() {
+		return "vincenty";
+	}
+
+	static Point point(const Coordinates &coords) {
+		const double toRadians = 3.14159265358979323846 / 180.0;
+		const double f = 1 / 298.257223563;
+		double U = atan((1 - f) * tan(coords.Lat * toRadians));
+		Point p;
+
+		p.LonRad = coords.Lon * toRadians;
+		p.SinU = sin(U);
+		p.CosU = cos(U);
+
+		return p;
+	}
+
+	static double miles(const Point &p1, const Point &p2) {
+		const double a = 6378137.0;  // Meters
+		const double f = 1 / 298.257223563;
+		const double b = a * (1 - f);
+		const double metersPerMile = 1609.344;
+		double L = p2.LonRad - p1.LonRad;
+		double lambda = L;
+		double sinSigma = 0, cosSigma = 1, sigma = 0;
+		double cosSqAlpha = 1, cos2SigmaM = 0;
+
+		for (int iteration = 0; iteration < 100; iteration++) {
+			double sinLambda = sin(lambda);
+			double cosLambda = cos(lambda);
+			double crossU = p1.CosU * p2.SinU - p1.SinU * p2.CosU * cosLambda;
+
+			sinSigma = sqrt((p2.CosU * sinLambda) * (p2.CosU * sinLambda) + crossU * crossU);
+
+			if (sinSigma == 0) {
+				return 0;  // Same point
+			}
+
+			cosSigma = p1.SinU * p2.SinU + p1.CosU * p2.CosU * cosLambda;
+			sigma = atan2(sinSigma, cosSigma);
+
+			double sinAlpha = p1.CosU * p2.CosU * sinLambda / sinSigma;
+
+			cosSqAlpha = 1 - sinAlpha * sinAlpha;
+			cos2SigmaM = (cosSqAlpha != 0) ? cosSigma - 2 * p1.SinU * p2.SinU / cosSqAlpha : 0;
+
+			double C = f / 16 * cosSqAlpha * (4 + f * (4 - 3 * cosSqAlpha));
+			double previous = lambda;
+
+			lambda = L + (1 - C) * f * sinAlpha * (sigma + C * sinSigma
+			* (cos2SigmaM + C * cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+
+			if (fabs(lambda - previous) < 1e-12) {
+				break;
+			}
+		}
+
+		double uSq = cosSqAlpha * (a * a - b * b) / (b * b);
+		double A = 1 + uSq / 16384 * (4096 + uSq * (-768 + uSq * (320 - 175 * uSq)));
+		double B = uSq / 1024 * (256 + uSq * (-128 + uSq * (74 - 47 * uSq)));
+		double deltaSigma = B * sinSigma * (cos2SigmaM + B / 4 * (cosSigma
+		* (-1 + 2 * cos2SigmaM * cos2SigmaM) - B / 6 * cos2SigmaM
+		* (-3 + 4 * sinSigma * sinSigma) * (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+
+		return b * A * (sigma - deltaSigma) / metersPerMile;
+	}
+};
+
+#ifndef DISTANCE_METRIC
+#define DISTANCE_METRIC LawOfCosinesMetric
+#endif
+
+// The metric of the edge weights and the A* bound, see the top
+typedef DISTANCE_METRIC DistanceMetric;
+
+//
+// MetricMiles
+//
+// MetricT distance between two coordinates, converting both first.  For
+// many distances, keep the converted points in MetricCoordinates.
+//
+template<typename MetricT>
+inline double MetricMiles(const Coordinates &a, const Coordinates &b) {
+	return MetricT::miles(MetricT::point(a), MetricT::point(b));
+}
+
+//
+// MetricCoordinates
+//
+// Every node converted once to MetricT's form, at the same index as in
+// NodeCoords.
+//
+template<typename MetricT>
+class MetricCoordinates {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<typename MetricT::Point> Points;
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	MetricCoordinates() {
+	}
+
+	explicit MetricCoordinates(const vector<Coordinates> &NodeCoords) {
+		Points.reserve(NodeCoords.size());
+
+		for (const Coordinates &coords : NodeCoords) {
+			Points.push_back(MetricT::point(coords));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumPoints() const {
+		return (int) Points.size();
+	}
+
+	const typename MetricT::Point& operator[](size_t index) const {
+		return Points[index];
+	}
+
+	double miles(size_t from, size_t to) const {
+		return MetricT::miles(Points[from], Points[to]);
+	}
+};
+
+//
+// MetricDistances
+//
+// miles[i] = MetricT distance from node from[i] to node to[i], e.g. the
+// weights of a list of edges.  from and to must be the same size.
+//
+template<typename MetricT>
+inline void MetricDistances(const vector<Coordinates> &NodeCoords,
+const vector<uint32_t> &from, const vector<uint32_t> &to, vector<double> &miles) {
+	MetricCoordinates<MetricT> nodePoints(NodeCoords);
+
+	miles.resize(from.size());
+
+	for (size_t i = 0; i < from.size(); i++) {
+		miles[i] = nodePoints.miles(from[i], to[i]);
+	}
+}
+
+// The default metric has a SIMD version, see greatcircle.h
+template<>
+inline void MetricDistances<LawOfCosinesMetric>(const vector<Coordinates> &NodeCoords,
+const vector<uint32_t> &from, const vector<uint32_t> &to, vector<double> &miles) {
+	GreatCirclePoints(NodeCoords).distancesBetween(from, to, miles);
+}
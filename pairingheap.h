@@ -0,0 +1,246 @@
+// pairingheap.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Indexed pairing heap of (index, distance) pairs with decrease-key.
+//
+// A pairing heap is a tree where every node is no larger than its
+// children.  Push and decrease-key just link a node (or the subtree it
+// heads) under the root or the root under it, in O(1); all of the work is
+// deferred to pop, which pairs up the root's children and merges the
+// pairs back into one tree.  Like IndexedDaryHeap (see daryheap.h), each
+// vertex has one node, kept in arrays over the dense vertex indices.
+//
+// Example:
+//    PairingHeap queue;
+//    DijkstraPath(CG, startV, destV, path, workspace, queue);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+class PairingHeap {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Node arrays, [index] = ...  Children of a node form a list through
+	// Sibling; Prev is the left sibling, or the parent for a first child.
+	//
+	vector<double> Distances;
+	vector<int> Child;
+	vector<int> Sibling;
+	vector<int> Prev;
+	vector<unsigned> Member;  // == Generation if the index is in the heap
+	unsigned Generation;
+
+	int Root;  // -1 if empty
+	int Size;
+
+	vector<int> Pairs;  // Scratch space for pop, kept between calls
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Smaller distance first, ties go to the smaller index, the same
+	// order as prioritizeIndex in algs.h.
+	//
+	bool before(int a, int b) const {
+		if (Distances[a] != Distances[b]) {
+			return Distances[a] < Distances[b];
+		}
+
+		return a < b;
+	}
+
+	//
+	// link
+	//
+	// Merges the trees rooted at a and b (which have no siblings) and
+	// returns the new root.
+	//
+	int link(int a, int b) {
+		int winner = before(a, b) ? a : b;
+		int loser = (winner == a) ? b : a;
+
+		Sibling[loser] = Child[winner];
+
+		if (Child[winner] != -1) {
+			Prev[Child[winner]] = loser;
+		}
+
+		Prev[loser] = winner;
+		Child[winner] = loser;
+		Sibling[winner] = -1;
+		Prev[winner] = -1;
+
+		return winner;
+	}
+
+	//
+	// cut
+	//
+	// Detaches the subtree rooted at index from its parent and siblings.
+	//
+	void cut(int index) {
+		int prev = Prev[index];
+
+		if (Child[prev] == index) {
+			Child[prev] = Sibling[index];
+		} else {
+			Sibling[prev] = Sibling[index];
+		}
+
+		if (Sibling[index] != -1) {
+			Prev[Sibling[index]] = prev;
+		}
+
+		Sibling[index] = -1;
+		Prev[index] = -1;
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	PairingHeap() {
+		Generation = 0;
+		Root = -1;
+		Size = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// clear
+	//
+	// Empties the heap in O(1) and makes room for indices
+	// 0..numVertices-1.
+	//
+	void clear(int numVertices) {
+		if ((int) Member.size() < numVertices) {
+			Distances.resize(numVertices);
+			Child.resize(numVertices);
+			Sibling.resize(numVertices);
+			Prev.resize(numVertices);
+			Member.resize(numVertices, 0);
+		}
+
+		Generation++;
+
+		if (Generation == 0) {  // wrapped, old stamps could look current
+			fill(Member.begin(), Member.end(), 0);
+			Generation = 1;
+		}
+
+		Root = -1;
+		Size = 0;
+	}
+
+	bool empty() const {
+		return Root == -1;
+	}
+
+	int size() const {
+		return Size;
+	}
+
+	bool contains(int index) const {
+		return Member[index] == Generation;
+	}
+
+	//
+	// push
+	//
+	// Inserts index with the given distance, or, if index is already in
+	// the heap, lowers it to the new distance (decrease-key).  A distance
+	// that is not lower than the current one is ignored.
+	//
+	void push(int index, double distance) {
+		if (!contains(index)) {
+			Distances[index] = distance;
+			Child[index] = -1;
+			Sibling[index] = -1;
+			Prev[index] = -1;
+			Member[index] = Generation;
+			Size++;
+
+			Root = (Root == -1) ? index : link(Root, index);
+		} else if (distance < Distances[index]) {
+			Distances[index] = distance;
+
+			if (index != Root) {
+				cut(index);
+				Root = link(Root, index);
+			}
+		}
+	}
+
+	//
+	// top
+	//
+	// Returns the (index, distance) with the smallest distance.  The heap
+	// must not be empty.
+	//
+	pair<int, double> top() const {
+		return make_pair(Root, Distances[Root]);
+	}
+
+	//
+	// pop
+	//
+	// Removes and returns the smallest entry.  The heap must not be empty.
+	// The root's children are linked in pairs left to right, then the
+	// pairs are merged right to left.
+	//
+	pair<int, double> pop() {
+		pair<int, double> smallest = top();
+
+		Pairs.clear();
+
+		for (int child = Child[Root]; child != -1; ) {
+			int next = Sibling[child];
+			Sibling[child] = -1;
+			Prev[child] = -1;
+
+			if (next == -1) {
+				Pairs.push_back(child);
+				break;
+			}
+
+			int after = Sibling[next];
+			Sibling[next] = -1;
+			Prev[next] = -1;
+
+			Pairs.push_back(link(child, next));
+			child = after;
+		}
+
+		int newRoot = -1;
+
+		for (int i = (int) Pairs.size() - 1; i >= 0; i--) {
+			newRoot = (newRoot == -1) ? Pairs[i] : link(Pairs[i], newRoot);
+		}
+
+		Member[Root] = Generation - 1;
+		Root = newRoot;
+		Size--;
+
+		return smallest;
+	}
+};
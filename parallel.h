@@ -0,0 +1,89 @@
+// parallel.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Small threading helpers shared by the parallel searches.
+//
+// Build with -pthread.
+//
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+//
+// defaultThreadCount
+//
+// The # of threads to use when the caller does not say: one per core, or
+// 1 if the # of cores is unknown.
+//
+inline int defaultThreadCount() {
+	unsigned cores = thread::hardware_concurrency();
+
+	return (cores == 0) ? 1 : (int) cores;
+}
+
+//
+// Barrier
+//
+// Meeting point for a fixed team of threads: wait() blocks until all
+// NumThreads threads have called it, then releases them together.  The
+// barrier can be reused for any # of rounds.
+//
+class Barrier {
+	private:
+	mutex Lock;
+	condition_variable AllArrived;
+	int NumThreads;
+	int Waiting;     // # of threads waiting in the current round
+	unsigned Round;  // Bumped each time the team is released
+
+	public:
+	explicit Barrier(int numThreads) {
+		NumThreads = numThreads;
+		Waiting = 0;
+		Round = 0;
+	}
+
+	void wait() {
+		unique_lock<mutex> guard(Lock);
+		unsigned round = Round;
+
+		if (++Waiting == NumThreads) {
+			Waiting = 0;
+			Round++;
+			AllArrived.notify_all();
+		} else {
+			AllArrived.wait(guard, [&]() { return Round != round; });
+		}
+	}
+};
+
+//
+// runTeam
+//
+// Runs work(t) for t = 0..numThreads-1, each on its own thread (t = 0 on
+// the calling thread), and returns once all of them have finished.
+//
+template<typename WorkT>
+void runTeam(int numThreads, WorkT work) {
+	vector<thread> team;
+
+	for (int t = 1; t < numThreads; t++) {
+		team.push_back(thread(work, t));
+	}
+
+	work(0);
+
+	for (thread &member : team) {
+		member.join();
+	}
+}
@@ -0,0 +1,437 @@
+// radixheap.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Integer-weight version of Dijkstra's algorithm built on a radix heap.
+//
+// Dijkstra only ever pops keys in increasing order, so its queue does not
+// need to be a general priority queue.  A radix heap takes advantage of
+// that: with integer keys, each entry sits in the bucket named by the
+// highest bit where it differs from the last key popped, and an entry can
+// only move to a lower bucket, at most 64 times in total.  Push is O(1)
+// and pop is amortized O(log C) where C is the largest edge weight,
+// without the comparisons and cache misses of a binary heap.
+//
+// Edge weights are miles, so they are first converted to fixed point
+// integers (see FixedPointWeights).
+//
+// Example:
+//    FixedPointWeights fixedWeights(CG);
+//    RadixHeap<int> queue;
+//    double miles = RadixDijkstraPath(CG, fixedWeights, startV, destV,
+//        path, workspace, queue);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+
+#include "csrgraph.h"
+#include "algs.h"
+
+using namespace std;
+
+//
+// RadixHeap
+//
+// Monotone min priority queue of (key, value) pairs with uint64_t keys.
+// Keys pushed must be >= the last key popped, which is always true of
+// the distances Dijkstra pushes.  Equal keys pop smallest value first,
+// so ValueT needs operator<.
+//
+template<typename ValueT>
+class RadixHeap {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Buckets[0] holds keys equal to Last; Buckets[i] holds keys whose
+	// highest bit that differs from Last is bit i - 1.
+	//
+	vector<pair<uint64_t, ValueT>> Buckets[65];
+	uint64_t Last;  // Last key popped, every key in the heap is >= Last
+	size_t Size;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	static int bucketOf(uint64_t key, uint64_t last) {
+		return (key == last) ? 0 : 64 - __builtin_clzll(key ^ last);
+	}
+
+	//
+	// refill
+	//
+	// Moves the smallest keys into Buckets[0] when it is empty: the
+	// lowest nonempty bucket is emptied, its minimum becomes Last, and
+	// its entries are spread over the buckets below it.
+	//
+	void refill() {
+		if (!Buckets[0].empty()) {
+			return;
+		}
+
+		int i = 1;
+
+		while (Buckets[i].empty()) {
+			i++;
+		}
+
+		uint64_t newLast = Buckets[i][0].first;
+
+		for (const pair<uint64_t, ValueT> &entry : Buckets[i]) {
+			newLast = min(newLast, entry.first);
+		}
+
+		Last = newLast;
+
+		for (const pair<uint64_t, ValueT> &entry : Buckets[i]) {
+			Buckets[bucketOf(entry.first, Last)].push_back(entry);
+		}
+
+		Buckets[i].clear();
+	}
+
+	//
+	// selectMin
+	//
+	// Refills Buckets[0] and moves its smallest value to the back, which
+	// is where top(), pop() and popMin() look.  Scans all of Buckets[0].
+	//
+	void selectMin() {
+		refill();
+
+		vector<pair<uint64_t, ValueT>> &bucket = Buckets[0];
+		size_t best = bucket.size() - 1;
+
+		for (size_t i = 0; i + 1 < bucket.size(); i++) {
+			if (bucket[i].second < bucket[best].second) {
+				best = i;
+			}
+		}
+
+		swap(bucket[best], bucket.back());
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	RadixHeap() {
+		Last = 0;
+		Size = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	bool empty() const {
+		return Size == 0;
+	}
+
+	size_t size() const {
+		return Size;
+	}
+
+	//
+	// clear
+	//
+	// Empties the heap and allows any key again.  Bucket storage is kept
+	// so a reused heap does not allocate.
+	//
+	void clear() {
+		for (vector<pair<uint64_t, ValueT>> &bucket : Buckets) {
+			bucket.clear();
+		}
+
+		Last = 0;
+		Size = 0;
+	}
+
+	//
+	// push
+	//
+	// Adds value with the given key.  Throws logic_error if the key is
+	// smaller than the last key popped.
+	//
+	void push(uint64_t key, const ValueT &value) {
+		if (key < Last) {
+			throw logic_error("RadixHeap::push: key is below the last key popped");
+		}
+
+		Buckets[bucketOf(key, Last)].push_back(make_pair(key, value));
+		Size++;
+	}
+
+	//
+	// top
+	//
+	// Returns an entry with the smallest key.  The heap must not be empty.
+	//
+	const pair<uint64_t, ValueT>& top() {
+		selectMin();
+
+		return Buckets[0].back();
+	}
+
+	//
+	// pop
+	//
+	// Removes the entry top() returns.  The heap must not be empty.
+	//
+	void pop() {
+		selectMin();
+
+		Buckets[0].pop_back();
+		Size--;
+	}
+
+	//
+	// popMin
+	//
+	// Removes and returns an entry with the smallest key, the one top()
+	// returns, selecting it only once.  The heap must not be empty.
+	//
+	pair<uint64_t, ValueT> popMin() {
+		selectMin();
+
+		pair<uint64_t, ValueT> entry = Buckets[0].back();
+
+		Buckets[0].pop_back();
+		Size--;
+
+		return entry;
+	}
+};
+
+//
+// RadixHeapQueue
+//
+// Dijkstra queue policy (see DijkstraSearch in algs.h) on a radix heap
+// over the double distances themselves.  For doubles >= 0 the IEEE 754
+// bit pattern, read as an unsigned integer, sorts the same way as the
+// value, so the bits are used as the key and no rounding is involved:
+// the search settles vertices in exactly the same order as with the
+// binary heap.
+//
+class RadixHeapQueue {
+	private:
+	RadixHeap<int> Heap;
+
+	static uint64_t toKey(double distance) {
+		uint64_t key;
+
+		memcpy(&key, &distance, sizeof(key));
+
+		return key;
+	}
+
+	static double toDistance(uint64_t key) {
+		double distance;
+
+		memcpy(&distance, &key, sizeof(distance));
+
+		return distance;
+	}
+
+	public:
+	void clear(int /*numVertices*/) {
+		Heap.clear();
+	}
+
+	bool empty() const {
+		return Heap.empty();
+	}
+
+	void push(int index, double distance) {
+		Heap.push(toKey(distance), index);
+	}
+
+	pair<int, double> pop() {
+		pair<uint64_t, int> top = Heap.popMin();
+
+		return make_pair(top.second, toDistance(top.first));
+	}
+};
+
+//
+// FixedPointWeights
+//
+// The edge weights of a csrgraph rounded to integer units of
+// 1 / UnitsPerMile miles, stored by edge position (see
+// csrgraph::edgeWeight).
+//
+// Precision: each weight is off by at most half a unit, so a path of k
+// edges is off by at most k / 2 units.  A search on these weights finds
+// a path P whose true length is within (|P| + |P*|) / 2 units of the
+// true shortest path P*, where |P| is the # of edges.  With 1e8 units
+// per mile that is under 0.0001 feet per edge, i.e. a route would need
+// hundreds of thousands of edges to be off by a foot.  Ties and
+// near-ties closer than that may be broken differently than by the
+// double searches in algs.h.
+//
+class FixedPointWeights {
+	private:
+	vector<uint32_t> Weights;  // [edge position] = weight in units
+
+	public:
+	static constexpr double UnitsPerMile = 1e8;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	FixedPointWeights() {
+	}
+
+	//
+	// Converts every edge weight of G with toUnits.  Throws out_of_range
+	// if a weight is negative or does not fit in 32 bits (about 42.9
+	// miles).
+	//
+	template<typename VertexT>
+	explicit FixedPointWeights(const csrgraph<VertexT, double> &G) {
+		Weights.reserve(G.NumEdges());
+
+		for (int e = 0; e < G.NumEdges(); e++) {
+			Weights.push_back(toUnits(G.edgeWeight(e)));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// toUnits
+	//
+	// Rounds miles to the nearest unit.  NaN, which the law of cosines
+	// gives for two footway nodes at the same spot (acos rounds past 1),
+	// and rounding errors just below zero are 0 units.  Throws
+	// out_of_range if the result is otherwise negative or does not fit in
+	// 32 bits.
+	//
+	static uint32_t toUnits(double miles) {
+		double units = round(miles * UnitsPerMile);
+
+		if (isnan(units) || (units < 0 && units >= -1)) {
+			return 0;
+		}
+
+		if (!(units >= 0 && units <= 4294967295.0)) {
+			throw out_of_range("FixedPointWeights: weight out of range");
+		}
+
+		return (uint32_t) units;
+	}
+
+	static double toMiles(uint64_t units) {
+		return units / UnitsPerMile;
+	}
+
+	int NumEdges() const {
+		return (int) Weights.size();
+	}
+
+	uint32_t weight(int e) const {
+		return Weights[e];
+	}
+};
+
+//
+// RadixDijkstraPath
+//
+// DijkstraPath (see algs.h) with integer distances and a radix heap.
+// fixedWeights must have been built from G.  Distances in state are the
+// integer units, stored as doubles (exact up to 2^53 units).
+//
+// Returns the length of the path found, added up from G's own weights
+// like PathDistance, and fills path in order.  If destV is unreachable
+// (or either vertex is missing), INF is returned and path is empty.
+// state and queue are the caller's reusable workspace.
+//
+template<typename VertexT>
+double RadixDijkstraPath(const csrgraph<VertexT, double> &G,
+const FixedPointWeights &fixedWeights, VertexT startV, VertexT destV,
+vector<VertexT> &path, SearchWorkspace &state, RadixHeap<int> &queue) {
+	int startIndex = G.indexOf(startV);
+	int destIndex = G.indexOf(destV);
+
+	path.clear();
+
+	if (startIndex < 0 || destIndex < 0 || fixedWeights.NumEdges() != G.NumEdges()) {
+		return INF;
+	}
+
+	state.reset(G.NumVertices());
+	queue.clear();
+
+	state.update(startIndex, 0, -1);
+	queue.push(0, startIndex);
+
+	while (!queue.empty()) {
+		pair<uint64_t, int> top = queue.popMin();
+		uint64_t currDist = top.first;
+		int currV = top.second;
+
+		if (state.settled(currV)) {  // stale entry
+			continue;
+		}
+
+		state.settle(currV);
+
+		if (currV == destIndex) {
+			break;
+		}
+
+		for (int e = G.edgesBegin(currV); e < G.edgesEnd(currV); e++) {
+			uint64_t altDist = currDist + fixedWeights.weight(e);
+
+			if (state.relax(G.edgeTarget(e), (double) altDist, currV)) {
+				queue.push(altDist, G.edgeTarget(e));
+			}
+		}
+	}
+
+	if (!state.settled(destIndex)) {  // unreachable
+		return INF;
+	}
+
+	vector<int> indices;
+
+	for (int index = destIndex; index != -1; index = state.predecessor(index)) {
+		indices.push_back(index);
+	}
+
+	reverse(indices.begin(), indices.end());
+
+	for (int index : indices) {
+		path.push_back(G.vertexAt(index));
+	}
+
+	return PathDistance(G, indices);
+}
+
+template<typename VertexT>
+double RadixDijkstraPath(const csrgraph<VertexT, double> &G,
+const FixedPointWeights &fixedWeights, VertexT startV, VertexT destV,
+vector<VertexT> &path) {
+	SearchWorkspace state;
+	RadixHeap<int> queue;
+
+	return RadixDijkstraPath(G, fixedWeights, startV, destV, path, state, queue);
+}
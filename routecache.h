@@ -0,0 +1,202 @@
+// routecache.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// RouteCache remembers the answers to recent building-to-building queries,
+// so a popular pair (e.g. SEO to SSB) is only looked up and routed once.
+// Entries are keyed by the buildings' positions in the building list and
+// hold everything needed to print the answer again: where both buildings
+// join the footways and the route between them.
+//
+// The cache holds at most Capacity entries and forgets the least recently
+// used one first.  Answers are only valid for the graph they were computed
+// on, so the cache is tied to a graph with setGraph(), which empties it
+// whenever a different graph is attached (e.g. after the map is reloaded).
+//
+// Example:
+//    RouteCache routes(64);
+//    routes.setGraph(CG);
+//    const CachedRoute *cached = routes.find(startBuilding, destBuilding);
+//    if (cached == nullptr) {
+//        ...look up the nodes and route...
+//        routes.insert(startBuilding, destBuilding, route);
+//    }
+//
+
+#pragma once
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+#include "csrgraph.h"
+#include "spatial.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// CachedRoute
+//
+// Answer to one building-to-building query.  Distance is INF (and Path
+// empty) if the destination could not be reached.
+//
+struct CachedRoute {
+	Coordinates StartNode;  // Footway node nearest to the start building
+	Coordinates DestNode;   // Footway node nearest to the destination
+	SegmentSnap StartSnap;  // Or, when snapping to footway segments,
+	SegmentSnap DestSnap;   // the closest points on them
+	double Distance;
+	vector<uint32_t> Path;  // Node indices from StartNode to DestNode
+};
+
+class RouteCache {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Type Definitions
+	////////////////////////////////////////////////////////////////////////////
+
+	struct Entry {
+		uint64_t Key;
+		CachedRoute Route;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	int Capacity;
+	list<Entry> Entries;  // Most recently used first
+	unordered_map<uint64_t, list<Entry>::iterator> ByKey;
+	uint64_t Fingerprint;  // GraphFingerprint() of the attached graph, or 0
+	uint64_t nHits;
+	uint64_t nMisses;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	static uint64_t keyOf(int startBuilding, int destBuilding) {
+		return ((uint64_t) (uint32_t) startBuilding << 32) | (uint32_t) destBuilding;
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Cache holding at most capacity routes; 0 turns it off.
+	//
+	explicit RouteCache(int capacity = 64) {
+		Capacity = max(capacity, 0);
+		Fingerprint = 0;
+		nHits = 0;
+		nMisses = 0;
+	}
+
+	// ByKey points into Entries, so a copy would point into the original
+	RouteCache(const RouteCache &) = delete;
+	RouteCache& operator=(const RouteCache &) = delete;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int capacity() const {
+		return Capacity;
+	}
+
+	int size() const {
+		return (int) Entries.size();
+	}
+
+	uint64_t hits() const {
+		return nHits;
+	}
+
+	uint64_t misses() const {
+		return nMisses;
+	}
+
+	//
+	// setGraph
+	//
+	// Ties the cache to the graph its routes are computed on.  If G is
+	// not the graph attached before, every cached route is dropped.
+	//
+	template<typename VertexT>
+	void setGraph(const csrgraph<VertexT, double> &G) {
+		uint64_t fingerprint = GraphFingerprint(G);
+
+		if (fingerprint != Fingerprint) {
+			clear();
+			Fingerprint = fingerprint;
+		}
+	}
+
+	//
+	// find
+	//
+	// The cached route from building # startBuilding to building #
+	// destBuilding, or nullptr.  A hit makes it the most recently used
+	// entry.  The pointer is valid until the next insert or clear.
+	//
+	const CachedRoute* find(int startBuilding, int destBuilding) {
+		auto found = ByKey.find(keyOf(startBuilding, destBuilding));
+
+		if (found == ByKey.end()) {
+			nMisses++;
+			return nullptr;
+		}
+
+		nHits++;
+		Entries.splice(Entries.begin(), Entries, found->second);
+
+		return &Entries.front().Route;
+	}
+
+	//
+	// insert
+	//
+	// Caches (or replaces) the route between the two buildings, evicting
+	// the least recently used entry if the cache is full.
+	//
+	void insert(int startBuilding, int destBuilding, const CachedRoute &route) {
+		uint64_t key = keyOf(startBuilding, destBuilding);
+		auto found = ByKey.find(key);
+
+		if (Capacity == 0) {
+			return;
+		}
+
+		if (found != ByKey.end()) {
+			found->second->Route = route;
+			Entries.splice(Entries.begin(), Entries, found->second);
+			return;
+		}
+
+		if ((int) Entries.size() == Capacity) {
+			ByKey.erase(Entries.back().Key);
+			Entries.pop_back();
+		}
+
+		Entries.push_front(Entry{key, route});
+		ByKey[key] = Entries.begin();
+	}
+
+	//
+	// clear
+	//
+	// Drops every cached route.  The hit and miss counters are kept.
+	//
+	void clear() {
+		Entries.clear();
+		ByKey.clear();
+	}
+};
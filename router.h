@@ -0,0 +1,304 @@
+// router.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Router answers "shortest footway route from node A to node B" queries
+// over the frozen footway graph using one of the searches in algs.h.  The
+// graph and coordinates are shared and read-only; each Router owns its
+// own search workspaces, so use one Router per thread.
+//
+// A Router can also keep the shortest path trees of recent start nodes
+// (see cacheTrees), so repeated queries from the same place are answered
+// without searching again.
+//
+// Example:
+//    Router router(CG, NodeCoords, ROUTE_ASTAR);
+//    vector<uint32_t> path;
+//    double miles = router.route(startIndex, destIndex, path);
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+
+#include "csrgraph.h"
+#include "algs.h"
+#include "heuristics.h"
+#include "metrics.h"
+#include "alt.h"
+#include "ch.h"
+#include "radixheap.h"
+#include "treecache.h"
+#include "spatial.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// RouteAlgorithm
+//
+// Which search the Router runs.  They all return the same shortest
+// distance; they differ in how much of the map they explore to find it.
+//
+enum RouteAlgorithm {
+	ROUTE_DIJKSTRA,       // DijkstraPath, grows a circle around the start
+	ROUTE_BIDIRECTIONAL,  // BidirectionalDijkstraPath, two circles that meet
+	ROUTE_ASTAR,          // AStarPath with the straight line heuristic
+	ROUTE_ALT,            // AStarPath with landmark bounds, see alt.h
+	ROUTE_CH,             // Contraction hierarchy query, see ch.h
+	ROUTE_RADIX           // DijkstraPath on fixed point weights, see radixheap.h
+};
+
+//
+// parseRouteAlgorithm
+//
+// Translates a name ("dijkstra", "bidirectional", "astar", "alt", "ch" or
+// "radix") into a RouteAlgorithm.  Returns false if the name is not recognized.
+//
+inline bool parseRouteAlgorithm(const string &name, RouteAlgorithm &algorithm) {
+	if (name == "dijkstra") {
+		algorithm = ROUTE_DIJKSTRA;
+	} else if (name == "bidirectional") {
+		algorithm = ROUTE_BIDIRECTIONAL;
+	} else if (name == "astar") {
+		algorithm = ROUTE_ASTAR;
+	} else if (name == "alt") {
+		algorithm = ROUTE_ALT;
+	} else if (name == "ch") {
+		algorithm = ROUTE_CH;
+	} else if (name == "radix") {
+		algorithm = ROUTE_RADIX;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+class Router {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	const csrgraph<uint32_t, double> *G;   // Footway graph, symmetric
+	const vector<Coordinates> *NodeCoords;  // [index] = coordinates
+	const ALTLandmarks<uint32_t> *Landmarks;  // Needed for ROUTE_ALT only
+	const ContractionHierarchy<uint32_t> *CH;  // Needed for ROUTE_CH only
+	const FixedPointWeights *FixedWeights;     // Needed for ROUTE_RADIX only
+
+	// NodeCoords converted for the A* heuristic, shared by copies of this
+	// Router; null unless the search can end up in ROUTE_ASTAR
+	shared_ptr<const MetricCoordinates<DistanceMetric>> NodePoints;
+	RouteAlgorithm Algorithm;
+
+	SearchWorkspace Forward;   // Used by every algorithm
+	SearchWorkspace Backward;  // Backward half of the bidirectional search
+	RadixHeap<int> RadixQueue; // Queue of ROUTE_RADIX
+
+	ShortestPathTreeCache<uint32_t> Trees;  // Off unless cacheTrees is called
+	int LastStart;  // Start index of the previous query, or -1
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// G, NodeCoords, landmarks, CH and fixedWeights must outlive the
+	// Router.  Vertices of G are the dense node indices from idmap.h,
+	// which also index NodeCoords.  landmarks, CH and fixedWeights must
+	// have been built on G.  Without its table each algorithm falls back:
+	// ROUTE_CH to ROUTE_ALT, ROUTE_ALT to ROUTE_ASTAR, and ROUTE_RADIX to
+	// ROUTE_DIJKSTRA.  So ROUTE_CH without CH uses the landmarks if there
+	// are any, and A* otherwise.
+	//
+	Router(const csrgraph<uint32_t, double> &G,
+	       const vector<Coordinates> &NodeCoords,
+	       RouteAlgorithm algorithm,
+	       const ALTLandmarks<uint32_t> *landmarks = nullptr,
+	       const ContractionHierarchy<uint32_t> *CH = nullptr,
+	       const FixedPointWeights *fixedWeights = nullptr) {
+		this->G = &G;
+		this->NodeCoords = &NodeCoords;
+		this->Landmarks = landmarks;
+		this->CH = CH;
+		this->FixedWeights = fixedWeights;
+		this->Algorithm = algorithm;
+		this->LastStart = -1;
+
+		// ROUTE_ASTAR, or a fall back to it (see search)
+		if (algorithm == ROUTE_ASTAR
+		    || (algorithm == ROUTE_ALT && landmarks == nullptr)
+		    || (algorithm == ROUTE_CH && CH == nullptr && landmarks == nullptr)) {
+			this->NodePoints = make_shared<const MetricCoordinates<DistanceMetric>>(NodeCoords);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	RouteAlgorithm algorithm() const {
+		return this->Algorithm;
+	}
+
+	//
+	// cacheTrees
+	//
+	// Keeps the shortest path trees of up to capacity start nodes (0
+	// turns the cache off, the default).  A tree is built the second time
+	// in a row a query leaves from the same node; from then on queries
+	// from that node are answered from the tree, whatever the algorithm.
+	// One-off starts still get the cheaper point-to-point search.
+	//
+	void cacheTrees(int capacity) {
+		Trees = ShortestPathTreeCache<uint32_t>(capacity);
+		LastStart = -1;
+	}
+
+	const ShortestPathTreeCache<uint32_t>& treeCache() const {
+		return Trees;
+	}
+
+	//
+	// route
+	//
+	// Returns the shortest distance in miles from startIndex to destIndex
+	// and fills path with the node indices along the way, in order.  If
+	// the destination is unreachable, INF is returned and path is empty.
+	//
+	double route(uint32_t startIndex, uint32_t destIndex, vector<uint32_t> &path) {
+		if (Trees.capacity() > 0 && startIndex < (uint32_t) G->NumVertices()) {
+			const ShortestPathTree *tree = Trees.find((int) startIndex);
+			bool repeated = ((int) startIndex == LastStart);
+
+			LastStart = (int) startIndex;
+
+			if (tree == nullptr && repeated) {
+				tree = &Trees.build(*G, (int) startIndex, Forward);
+			}
+
+			if (tree != nullptr) {
+				if (destIndex >= (uint32_t) G->NumVertices()) {
+					path.clear();
+					return INF;
+				}
+
+				return tree->pathTo(*G, (int) destIndex, path);
+			}
+		}
+
+		return search(startIndex, destIndex, path);
+	}
+
+	//
+	// routeSnapped
+	//
+	// Shortest route between two points snapped onto footway segments
+	// (see rtree.h), treating each point as a vertex part way along its
+	// segment.  G is not changed.  Returns the distance in miles and fills
+	// path with the node indices between the two points, which is empty
+	// when the shortest way is straight along a shared segment.  If the
+	// destination is unreachable, INF is returned and path is empty.
+	//
+	// Always a Dijkstra search, whatever the algorithm: the others need a
+	// single start and destination node.
+	//
+	double routeSnapped(const SegmentSnap &start, const SegmentSnap &dest,
+	vector<uint32_t> &path) {
+		vector<pair<uint32_t, double>> starts, dests;
+		double direct = INF;
+
+		path.clear();
+
+		if (start.From == NO_INDEX || dest.From == NO_INDEX) {
+			return INF;
+		}
+
+		// Both points on the same segment: straight along it
+		if (start.From == dest.From && start.To == dest.To) {
+			direct = fabs(start.Fraction - dest.Fraction) * start.Length;
+		} else if (start.From == dest.To && start.To == dest.From) {
+			direct = fabs(start.Fraction - (1 - dest.Fraction)) * start.Length;
+		}
+
+		starts.push_back(make_pair(start.From, start.Fraction * start.Length));
+		starts.push_back(make_pair(start.To, (1 - start.Fraction) * start.Length));
+		dests.push_back(make_pair(dest.From, dest.Fraction * dest.Length));
+		dests.push_back(make_pair(dest.To, (1 - dest.Fraction) * dest.Length));
+
+		double distance = DijkstraSeededPath(*G, starts, dests, path, Forward);
+
+		if (direct <= distance) {
+			path.clear();
+			return direct;
+		}
+
+		return distance;
+	}
+
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// search
+	//
+	// route() without the tree cache: one point-to-point search with the
+	// chosen algorithm.
+	//
+	double search(uint32_t startIndex, uint32_t destIndex, vector<uint32_t> &path) {
+		switch (Algorithm) {
+			case ROUTE_RADIX:
+				if (FixedWeights != nullptr) {
+					return RadixDijkstraPath(*G, *FixedWeights, startIndex, destIndex,
+					path, Forward, RadixQueue);
+				}
+				// fall through
+
+			case ROUTE_DIJKSTRA:
+				return DijkstraPath(*G, startIndex, destIndex, path, Forward);
+
+			case ROUTE_BIDIRECTIONAL:
+				// Every footway edge goes both ways, so G is its own reverse
+				return BidirectionalDijkstraPath(*G, *G, startIndex, destIndex,
+				path, Forward, Backward);
+
+			case ROUTE_CH:
+				if (CH != nullptr) {
+					return CH->route(*G, startIndex, destIndex, path, Forward, Backward);
+				}
+				// fall through
+
+			case ROUTE_ALT:
+				if (Landmarks != nullptr) {
+					ALTHeuristic<uint32_t> heuristic(*Landmarks, *G, startIndex, destIndex);
+
+					return AStarPath(*G, startIndex, destIndex, heuristic, path, Forward);
+				}
+				// fall through
+
+			case ROUTE_ASTAR:
+			default: {
+				if (destIndex >= NodeCoords->size()) {
+					path.clear();
+					return INF;
+				}
+
+				MetricHeuristic<DistanceMetric> heuristic(*NodePoints, (*NodeCoords)[destIndex]);
+
+				return AStarPath(*G, startIndex, destIndex, heuristic, path, Forward);
+			}
+		}
+	}
+};
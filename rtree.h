@@ -0,0 +1,393 @@
+// rtree.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// FootwayRTree snaps a point (e.g. a building) to the closest spot on any
+// footway segment, rather than to the closest footway node.  A building
+// next to a long straight footway is then placed beside it, not at a far
+// away end of it.
+//
+// The index is a packed Hilbert R-tree over the bounding boxes of the
+// segments.  The segments are sorted along a Hilbert curve through the
+// map, so neighbors on the curve are neighbors on the ground, and then
+// packed NodeSize at a time into leaves, the leaves NodeSize at a time
+// into parents, and so on up to a single root.  The tree is built once
+// and never changes.  A query visits boxes closest first and stops as
+// soon as the next box is farther than the best segment found.
+//
+// Distances are measured on a flat projection of the map around the
+// query (equirectangular), which over a campus differs from the distance
+// along the earth by far less than a millimeter.
+//
+// Example:
+//    FootwayRTree footwaySegments(Footways, mapper, NodeCoords);
+//    SegmentSnap snap;
+//    footwaySegments.nearest(building.Coords, snap);
+//    // snap.From, snap.To and snap.Fraction locate the point
+//
+
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+
+#include "spatial.h"
+#include "metrics.h"
+
+using namespace std;
+
+//
+// Allowed relative error in a squared distance in miles when pruning
+// boxes: anything within bestSquared * (1 + RTreeSlack) is still looked
+// at.  Unlike SpatialSlack (an absolute bound on the unit sphere) this
+// scales with the distance, since the flat projection rounds in
+// proportion to it.
+//
+const double RTreeSlack = 1e-13;
+
+class FootwayRTree {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Type Definitions
+	////////////////////////////////////////////////////////////////////////////
+
+	struct Box {
+		double MinLat, MinLon;
+		double MaxLat, MaxLon;
+	};
+
+	//
+	// Segment: one pair of consecutive footway nodes.  Rank is its
+	// position in the footways, used to break ties.
+	//
+	struct Segment {
+		Box Bounds;
+		uint32_t From;
+		uint32_t To;
+		double Length;
+		long long FootwayID;
+		uint32_t Rank;
+	};
+
+	//
+	// Node: a box around its children, which are Segments[First,
+	// First + Count) for a leaf and Nodes[First, First + Count) otherwise.
+	//
+	struct Node {
+		Box Bounds;
+		int First;
+		int Count;
+		bool Leaf;
+	};
+
+	//
+	// Flat projection around a query point: miles east (x) and north (y)
+	// of it.
+	//
+	struct Projection {
+		double Lat, Lon;
+		double MilesPerLat, MilesPerLon;
+
+		Projection(double lat, double lon) {
+			Lat = lat;
+			Lon = lon;
+			MilesPerLat = EarthRadiusMiles * TrigPI / 180.0;
+			MilesPerLon = MilesPerLat * cos(lat * TrigPI / 180.0);
+		}
+
+		double x(double lon) const {
+			return (lon - Lon) * MilesPerLon;
+		}
+
+		double y(double lat) const {
+			return (lat - Lat) * MilesPerLat;
+		}
+
+		//
+		// Squared distance to the closest point of box; 0 if inside.
+		//
+		double squaredDistance(const Box &box) const {
+			double dx = max(max(x(box.MinLon), -x(box.MaxLon)), 0.0);
+			double dy = max(max(y(box.MinLat), -y(box.MaxLat)), 0.0);
+
+			return dx * dx + dy * dy;
+		}
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	static const int NodeSize = 16;  // Children per node
+
+	vector<Segment> Segments;     // In Hilbert order
+	vector<Node> Nodes;           // Leaves first, the root last
+	const vector<Coordinates> *NodeCoords;
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// hilbertIndex
+	//
+	// Position of cell (x, y) along a Hilbert curve filling a 2^16 x 2^16
+	// grid.
+	//
+	static uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+		uint64_t d = 0;
+
+		for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+			uint32_t rx = (x & s) ? 1 : 0;
+			uint32_t ry = (y & s) ? 1 : 0;
+
+			d += (uint64_t) s * s * ((3 * rx) ^ ry);
+
+			// Rotate the quadrant so the curve stays continuous
+			if (ry == 0) {
+				if (rx == 1) {
+					x = s - 1 - (x & (s - 1));
+					y = s - 1 - (y & (s - 1));
+				}
+
+				swap(x, y);
+			}
+		}
+
+		return d;
+	}
+
+	static void grow(Box &box, const Box &other) {
+		box.MinLat = min(box.MinLat, other.MinLat);
+		box.MinLon = min(box.MinLon, other.MinLon);
+		box.MaxLat = max(box.MaxLat, other.MaxLat);
+		box.MaxLon = max(box.MaxLon, other.MaxLon);
+	}
+
+	//
+	// consider
+	//
+	// Projects the query (the origin of projection) onto segment and
+	// keeps it in snap if it is closer than the best so far, or as close
+	// and earlier in the footways.  bestSquared and bestRank describe the
+	// current best.
+	//
+	void consider(const Segment &segment, const Projection &projection,
+	SegmentSnap &snap, double &bestSquared, uint32_t &bestRank) const {
+		const Coordinates &from = (*NodeCoords)[segment.From];
+		const Coordinates &to = (*NodeCoords)[segment.To];
+		double ax = projection.x(from.Lon);
+		double ay = projection.y(from.Lat);
+		double dx = projection.x(to.Lon) - ax;
+		double dy = projection.y(to.Lat) - ay;
+		double lengthSquared = dx * dx + dy * dy;
+		double t = 0;
+
+		if (lengthSquared > 0) {
+			t = min(max(-(ax * dx + ay * dy) / lengthSquared, 0.0), 1.0);
+		}
+
+		double px = ax + t * dx;
+		double py = ay + t * dy;
+
+		// The end itself, so segments sharing the nearest node tie exactly
+		if (t == 1) {
+			px = projection.x(to.Lon);
+			py = projection.y(to.Lat);
+		}
+		double squared = px * px + py * py;
+
+		if (squared < bestSquared || (squared == bestSquared && segment.Rank < bestRank)) {
+			bestSquared = squared;
+			bestRank = segment.Rank;
+
+			snap.From = segment.From;
+			snap.To = segment.To;
+			snap.Length = segment.Length;
+			snap.Fraction = t;
+			snap.Lat = from.Lat + t * (to.Lat - from.Lat);
+			snap.Lon = from.Lon + t * (to.Lon - from.Lon);
+			snap.Miles = sqrt(squared);
+			snap.FootwayID = segment.FootwayID;
+		}
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	FootwayRTree() {
+		NodeCoords = nullptr;
+	}
+
+	//
+	// Indexes every segment of every footway.  mapper translates the node
+	// IDs into indices of NodeCoords, which must outlive the tree.
+	//
+	FootwayRTree(const vector<FootwayInfo> &Footways, const IDMapper &mapper,
+	const vector<Coordinates> &NodeCoords) {
+		this->NodeCoords = &NodeCoords;
+
+		////////////////////////////////////////////
+		// One Segment per consecutive node pair //
+		////////////////////////////////////////////
+
+		for (const FootwayInfo &footway : Footways) {
+			for (int i = 0; i + 1 < (int) footway.Nodes.size(); i++) {
+				Segment segment;
+				const Coordinates &from = NodeCoords[mapper.toIndex(footway.Nodes[i])];
+				const Coordinates &to = NodeCoords[mapper.toIndex(footway.Nodes[i + 1])];
+
+				segment.From = mapper.toIndex(footway.Nodes[i]);
+				segment.To = mapper.toIndex(footway.Nodes[i + 1]);
+				segment.Length = MetricMiles<DistanceMetric>(from, to);
+
+				// acos can round to NaN for two nodes at the same spot
+				if (!(segment.Length >= 0)) {
+					segment.Length = 0;
+				}
+				segment.FootwayID = footway.ID;
+				segment.Rank = (uint32_t) Segments.size();
+				segment.Bounds = Box{ min(from.Lat, to.Lat), min(from.Lon, to.Lon),
+				max(from.Lat, to.Lat), max(from.Lon, to.Lon) };
+
+				Segments.push_back(segment);
+			}
+		}
+
+		if (Segments.empty()) {
+			return;
+		}
+
+		////////////////////////////////////////////////
+		// Sort the segments along the Hilbert curve //
+		////////////////////////////////////////////////
+
+		Box all = Segments[0].Bounds;
+
+		for (const Segment &segment : Segments) {
+			grow(all, segment.Bounds);
+		}
+
+		double latScale = 65535 / max(all.MaxLat - all.MinLat, 1e-12);
+		double lonScale = 65535 / max(all.MaxLon - all.MinLon, 1e-12);
+		vector<pair<uint64_t, int>> order;  // <Hilbert index, segment>
+
+		for (int i = 0; i < (int) Segments.size(); i++) {
+			const Box &box = Segments[i].Bounds;
+			uint32_t x = (uint32_t) (((box.MinLon + box.MaxLon) / 2 - all.MinLon) * lonScale);
+			uint32_t y = (uint32_t) (((box.MinLat + box.MaxLat) / 2 - all.MinLat) * latScale);
+
+			order.push_back(make_pair(hilbertIndex(x, y), i));
+		}
+
+		sort(order.begin(), order.end());
+
+		vector<Segment> sorted;
+
+		for (const pair<uint64_t, int> &entry : order) {
+			sorted.push_back(Segments[entry.second]);
+		}
+
+		Segments.swap(sorted);
+
+		////////////////////////////////////////
+		// Pack the leaves, then each level  //
+		////////////////////////////////////////
+
+		for (int first = 0; first < (int) Segments.size(); first += NodeSize) {
+			Node leaf = { Segments[first].Bounds, first,
+			min((int) NodeSize, (int) Segments.size() - first), true };
+
+			for (int i = first; i < first + leaf.Count; i++) {
+				grow(leaf.Bounds, Segments[i].Bounds);
+			}
+
+			Nodes.push_back(leaf);
+		}
+
+		int levelBegin = 0;
+
+		while ((int) Nodes.size() - levelBegin > 1) {
+			int levelEnd = (int) Nodes.size();
+
+			for (int first = levelBegin; first < levelEnd; first += NodeSize) {
+				Node parent = { Nodes[first].Bounds, first,
+				min((int) NodeSize, levelEnd - first), false };
+
+				for (int i = first; i < first + parent.Count; i++) {
+					grow(parent.Bounds, Nodes[i].Bounds);
+				}
+
+				Nodes.push_back(parent);
+			}
+
+			levelBegin = levelEnd;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumSegments() const {
+		return (int) Segments.size();
+	}
+
+	//
+	// nearest
+	//
+	// Snaps (lat, lon) to the closest point of any footway segment; on
+	// ties the segment that comes first in the footways wins.  Returns
+	// false (leaving snap alone) if there are no segments.
+	//
+	bool nearest(double lat, double lon, SegmentSnap &snap) const {
+		if (Nodes.empty()) {
+			return false;
+		}
+
+		typedef pair<double, int> Entry;  // <squared distance, node>
+
+		Projection projection(lat, lon);
+		priority_queue<Entry, vector<Entry>, greater<Entry>> boxes;
+		double bestSquared = INFINITY;
+		uint32_t bestRank = 0;
+
+		boxes.push(make_pair(projection.squaredDistance(Nodes.back().Bounds), (int) Nodes.size() - 1));
+
+		// Boxes are kept within a rounding error of the best, so a tie
+		// with an earlier segment is never pruned
+		while (!boxes.empty() && boxes.top().first <= bestSquared * (1 + RTreeSlack)) {
+			const Node &node = Nodes[boxes.top().second];
+
+			boxes.pop();
+
+			for (int i = node.First; i < node.First + node.Count; i++) {
+				if (node.Leaf) {
+					consider(Segments[i], projection, snap, bestSquared, bestRank);
+				} else {
+					double squared = projection.squaredDistance(Nodes[i].Bounds);
+
+					if (squared <= bestSquared * (1 + RTreeSlack)) {
+						boxes.push(make_pair(squared, i));
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool nearest(const Coordinates &point, SegmentSnap &snap) const {
+		return nearest(point.Lat, point.Lon, snap);
+	}
+};
@@ -0,0 +1,360 @@
+// scheduler.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Work-stealing scheduler for jobs made of many independent tasks of very
+// different cost, e.g. routes between adjacent buildings mixed with routes
+// across the whole map.
+//
+// parallelFor(count, body) calls body(i, worker) once for every i in
+// 0..count-1.  The indices are cut into chunks of "grain" tasks, and each
+// worker starts with its own deque of consecutive chunks.  A worker takes
+// chunks from the front of its own deque; when it runs dry it steals from
+// the back of another worker's deque, so no worker sits idle while there
+// is work left anywhere.
+//
+// The worker threads are started once and sleep between jobs.  The
+// calling thread works as worker 0, so a scheduler with N workers runs
+// N - 1 extra threads.  Each worker keeps counters (see WorkerStats) that
+// show how evenly a job was spread.
+//
+// Example:
+//    WorkStealingScheduler scheduler(8);
+//    scheduler.parallelFor(queries.size(), [&](size_t i, int worker) {
+//        results[i] = routers[worker].route(...);
+//    });
+//
+// Build with -pthread.
+//
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <utility>
+#include <cstdint>
+
+#include "parallel.h"
+
+using namespace std;
+
+//
+// WorkerStats
+//
+// Counters of one worker, summed over every job since the last
+// resetStats().  Busy time only counts time spent inside task bodies.
+//
+struct WorkerStats {
+	uint64_t Tasks;         // # of tasks (indices) run
+	uint64_t Chunks;        // # of chunks run, own and stolen
+	uint64_t Steals;        // # of chunks stolen from other workers
+	uint64_t FailedSteals;  // # of steal attempts that found nothing
+	double BusySeconds;
+
+	WorkerStats() {
+		Tasks = 0;
+		Chunks = 0;
+		Steals = 0;
+		FailedSteals = 0;
+		BusySeconds = 0;
+	}
+};
+
+class WorkStealingScheduler {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Type Definitions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Worker: one deque of [begin, end) chunks, guarded by its own lock so
+	// the owner and thieves only contend on the same worker.
+	//
+	struct Worker {
+		mutex Lock;
+		deque<pair<size_t, size_t>> Chunks;
+		WorkerStats Stats;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<unique_ptr<Worker>> Workers;
+	vector<thread> Threads;  // Workers 1..N-1; worker 0 is the caller
+
+	mutex JobLock;
+	condition_variable JobStarted;
+	condition_variable JobFinished;
+	unsigned JobNumber;  // Bumped for every job, wakes up the threads
+	int Active;          // # of pool threads still working on the job
+	bool Stopping;
+
+	function<void(size_t, int)> Body;  // Task body of the current job
+	atomic<size_t> Remaining;          // Chunks of the job not yet taken
+	exception_ptr Failure;             // First exception thrown by Body
+
+	////////////////////////////////////////////////////////////////////////////
+	// Private Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// take
+	//
+	// Gets the next chunk for worker w: from the front of its own deque,
+	// else stolen from the back of the others'.  Returns false once every
+	// chunk of the job has been taken.
+	//
+	bool take(int w, pair<size_t, size_t> &chunk) {
+		Worker &self = *Workers[w];
+		int n = (int) Workers.size();
+
+		while (Remaining.load() > 0) {
+			{
+				lock_guard<mutex> guard(self.Lock);
+
+				if (!self.Chunks.empty()) {
+					chunk = self.Chunks.front();
+					self.Chunks.pop_front();
+					Remaining--;
+					return true;
+				}
+			}
+
+			// Own deque is empty: try the others, starting after w
+			for (int i = 1; i < n; i++) {
+				Worker &victim = *Workers[(w + i) % n];
+				lock_guard<mutex> guard(victim.Lock);
+
+				if (!victim.Chunks.empty()) {
+					chunk = victim.Chunks.back();
+					victim.Chunks.pop_back();
+					Remaining--;
+					self.Stats.Steals++;
+					return true;
+				}
+			}
+
+			self.Stats.FailedSteals++;
+			this_thread::yield();
+		}
+
+		return false;
+	}
+
+	//
+	// work
+	//
+	// Runs chunks as worker w until the job has none left.
+	//
+	void work(int w) {
+		WorkerStats &stats = Workers[w]->Stats;
+		pair<size_t, size_t> chunk;
+
+		while (take(w, chunk)) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+			try {
+				for (size_t i = chunk.first; i < chunk.second; i++) {
+					Body(i, w);
+				}
+			} catch (...) {
+				lock_guard<mutex> guard(JobLock);
+
+				if (!Failure) {
+					Failure = current_exception();
+				}
+			}
+
+			stats.BusySeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			stats.Tasks += chunk.second - chunk.first;
+			stats.Chunks++;
+		}
+	}
+
+	//
+	// threadMain
+	//
+	// Loop of pool thread w: sleep until a job starts, work on it, report
+	// back, repeat until the scheduler is destroyed.
+	//
+	void threadMain(int w) {
+		unsigned seen = 0;
+
+		while (true) {
+			{
+				unique_lock<mutex> guard(JobLock);
+				JobStarted.wait(guard, [&]() { return Stopping || JobNumber != seen; });
+
+				if (Stopping) {
+					return;
+				}
+
+				seen = JobNumber;
+			}
+
+			work(w);
+
+			{
+				lock_guard<mutex> guard(JobLock);
+
+				if (--Active == 0) {
+					JobFinished.notify_all();
+				}
+			}
+		}
+	}
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors / Destructor
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Starts a scheduler with numWorkers workers (<= 0 means one per
+	// core).  The scheduler cannot be copied.
+	//
+	explicit WorkStealingScheduler(int numWorkers = 0) {
+		if (numWorkers <= 0) {
+			numWorkers = defaultThreadCount();
+		}
+
+		JobNumber = 0;
+		Active = 0;
+		Stopping = false;
+		Remaining = 0;
+
+		for (int w = 0; w < numWorkers; w++) {
+			Workers.push_back(unique_ptr<Worker>(new Worker()));
+		}
+
+		for (int w = 1; w < numWorkers; w++) {
+			Threads.push_back(thread(&WorkStealingScheduler::threadMain, this, w));
+		}
+	}
+
+	WorkStealingScheduler(const WorkStealingScheduler &) = delete;
+	WorkStealingScheduler& operator=(const WorkStealingScheduler &) = delete;
+
+	~WorkStealingScheduler() {
+		{
+			lock_guard<mutex> guard(JobLock);
+			Stopping = true;
+		}
+
+		JobStarted.notify_all();
+
+		for (thread &t : Threads) {
+			t.join();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumWorkers() const {
+		return (int) Workers.size();
+	}
+
+	//
+	// parallelFor
+	//
+	// Calls body(i, worker) for i = 0..count-1 across the workers and
+	// returns when all calls have finished.  worker is 0..NumWorkers()-1
+	// and no two calls with the same worker run at once, so it can index
+	// per-worker state such as search workspaces.  Tasks are handed out
+	// in chunks of grain consecutive indices.  If a call throws, the rest
+	// of its chunk is skipped and the first exception is rethrown here
+	// once the job has finished.
+	//
+	// Only one job runs at a time; do not call parallelFor from a body.
+	//
+	template<typename BodyT>
+	void parallelFor(size_t count, BodyT body, size_t grain = 1) {
+		if (count == 0) {
+			return;
+		}
+
+		if (grain == 0) {
+			grain = 1;
+		}
+
+		size_t numChunks = (count + grain - 1) / grain;
+		size_t numWorkers = Workers.size();
+
+		/////////////////////////////////////////////////////////////
+		// Deal each worker a run of consecutive chunks to start   //
+		/////////////////////////////////////////////////////////////
+
+		for (size_t w = 0; w < numWorkers; w++) {
+			size_t first = numChunks * w / numWorkers;
+			size_t last = numChunks * (w + 1) / numWorkers;
+
+			for (size_t c = first; c < last; c++) {
+				Workers[w]->Chunks.push_back(make_pair(c * grain, min(count, (c + 1) * grain)));
+			}
+		}
+
+		{
+			lock_guard<mutex> guard(JobLock);
+
+			Body = body;
+			Failure = nullptr;
+			Remaining = numChunks;
+			Active = (int) Threads.size();
+			JobNumber++;
+		}
+
+		JobStarted.notify_all();
+
+		work(0);
+
+		// The body must stay alive until every pool thread is done with it
+		unique_lock<mutex> guard(JobLock);
+		JobFinished.wait(guard, [&]() { return Active == 0; });
+
+		Body = nullptr;
+
+		if (Failure) {
+			exception_ptr failure = Failure;
+
+			Failure = nullptr;
+			rethrow_exception(failure);
+		}
+	}
+
+	//
+	// stats / resetStats
+	//
+	// Per-worker counters, indexed by worker #.  Only read them between
+	// jobs.
+	//
+	vector<WorkerStats> stats() const {
+		vector<WorkerStats> all;
+
+		for (const unique_ptr<Worker> &worker : Workers) {
+			all.push_back(worker->Stats);
+		}
+
+		return all;
+	}
+
+	void resetStats() {
+		for (unique_ptr<Worker> &worker : Workers) {
+			worker->Stats = WorkerStats();
+		}
+	}
+};
@@ -0,0 +1,199 @@
+// spatial.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Pieces shared by the footway indexes (kdtree.h, grid.h, rtree.h).
+//
+// Each index answers "which footway node is nearest to this building"
+// exactly like the original linear scan over every footway: distances
+// come from distBetween2Points and ties go to the node that comes first
+// in the footways.  To prune, the indexes place nodes on the unit sphere,
+// the same vectors distBetween2Points takes the dot product of, where the
+// straight line ("chord") distance grows with the distance along the
+// earth.  Pruning allows SpatialSlack for rounding, so it never drops a
+// node the scan could have picked.
+//
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#include "idmap.h"
+#include "dist.h"
+#include "trigcoords.h"
+#include "osm.h"
+
+using namespace std;
+
+//
+// Allowed error in squared chord length (unit sphere) between the
+// vectors here and the ones distBetween2Points rounds its way to.  The
+// dot product there is good to a few 1e-16, so this is very safe; it only
+// costs a few extra distance checks within a couple of meters of the best
+// node.
+//
+const double SpatialSlack = 1e-13;
+
+//
+// FootwayPoint
+//
+// One footway node.  Rank is its position in the footway scan order
+// (first appearance), used to break ties like the scan did.
+//
+struct FootwayPoint {
+	double Axis[3];  // Unit vector (x, y, z) on the sphere
+	double Lat;
+	double Lon;
+	uint32_t Index;
+	uint32_t Rank;
+};
+
+//
+// toUnitVector
+//
+// The point on the unit sphere for (lat, lon) in degrees.
+//
+inline void toUnitVector(double lat, double lon, double axis[3]) {
+	double latRad = lat * TrigPI / 180.0;
+	double lonRad = lon * TrigPI / 180.0;
+
+	axis[0] = cos(latRad) * cos(lonRad);
+	axis[1] = cos(latRad) * sin(lonRad);
+	axis[2] = sin(latRad);
+}
+
+inline double squaredChord(const double a[3], const double b[3]) {
+	double dx = a[0] - b[0];
+	double dy = a[1] - b[1];
+	double dz = a[2] - b[2];
+
+	return dx * dx + dy * dy + dz * dz;
+}
+
+//
+// FootwayPoints
+//
+// Every node of every footway, once, in the order the footways list
+// them.  mapper translates the node IDs into indices of NodeCoords.
+//
+inline vector<FootwayPoint> FootwayPoints(const vector<FootwayInfo> &Footways,
+const IDMapper &mapper, const vector<Coordinates> &NodeCoords) {
+	vector<FootwayPoint> points;
+	vector<bool> seen(NodeCoords.size(), false);
+
+	for (const FootwayInfo &footway : Footways) {
+		for (long long id : footway.Nodes) {
+			uint32_t index = mapper.toIndex(id);
+
+			// Later appearances would lose every tie to the first
+			if (seen[index]) {
+				continue;
+			}
+
+			FootwayPoint point;
+
+			toUnitVector(NodeCoords[index].Lat, NodeCoords[index].Lon, point.Axis);
+			point.Lat = NodeCoords[index].Lat;
+			point.Lon = NodeCoords[index].Lon;
+			point.Index = index;
+			point.Rank = (uint32_t) points.size();
+
+			seen[index] = true;
+			points.push_back(point);
+		}
+	}
+
+	return points;
+}
+
+//
+// NearestFootwayPoint
+//
+// Running winner of a nearest node search from (Lat, Lon).  Bound is the
+// squared chord distance of the winner: a node (or a whole region) whose
+// squared chord distance is above Bound + SpatialSlack cannot win.
+//
+struct NearestFootwayPoint {
+	double Lat;
+	double Lon;
+	double Query[3];  // Unit vector of (Lat, Lon)
+	const FootwayPoint *Best;
+	double Miles;
+	double Bound;
+
+	NearestFootwayPoint(double lat, double lon) {
+		Lat = lat;
+		Lon = lon;
+		toUnitVector(lat, lon, Query);
+		Best = nullptr;
+		Miles = INFINITY;
+		Bound = INFINITY;
+	}
+
+	//
+	// canBeat
+	//
+	// False if everything at least sqrt(squaredDistance) away along a
+	// chord is sure to lose.
+	//
+	bool canBeat(double squaredDistance) const {
+		return squaredDistance <= Bound + SpatialSlack;
+	}
+
+	//
+	// consider
+	//
+	// Measures point, and makes it the winner if it is closer, or as
+	// close and earlier in the footways.  The same test as the scan, so a
+	// NaN distance never wins.
+	//
+	void consider(const FootwayPoint &point) {
+		double chord = squaredChord(Query, point.Axis);
+
+		if (!canBeat(chord)) {
+			return;
+		}
+
+		double miles = distBetween2Points(Lat, Lon, point.Lat, point.Lon);
+
+		if (miles < Miles || (miles == Miles && Best != nullptr && point.Rank < Best->Rank)) {
+			Best = &point;
+			Miles = miles;
+			Bound = chord;
+		}
+	}
+
+	uint32_t index() const {
+		return (Best == nullptr) ? NO_INDEX : Best->Index;
+	}
+};
+
+//
+// SegmentSnap
+//
+// A point snapped onto a footway segment (see rtree.h): the spot on the
+// segment From -> To closest to the query, Fraction of the way along it.
+//
+struct SegmentSnap {
+	uint32_t From;       // Node indices of the segment's ends
+	uint32_t To;
+	double Length;       // Edge weight From -> To (see metrics.h)
+	double Fraction;     // 0 at From, 1 at To
+	double Lat;          // The snapped point
+	double Lon;
+	double Miles;        // From the query to the snapped point
+	long long FootwayID;
+
+	SegmentSnap() {
+		From = To = NO_INDEX;
+		Length = Fraction = 0;
+		Lat = Lon = 0;
+		Miles = INFINITY;
+		FootwayID = 0;
+	}
+};
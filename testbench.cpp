@@ -1,5 +1,28 @@
 #include <gtest/gtest.h>
 #include "graph.h"
+#include "csrgraph.h"
+#include "idmap.h"
+#include "algs.h"
+#include "heuristics.h"
+#include "alt.h"
+#include "ch.h"
+#include "radixheap.h"
+#include "daryheap.h"
+#include "pairingheap.h"
+#include "bucketqueue.h"
+#include "deltastep.h"
+#include "batch.h"
+#include "scheduler.h"
+#include "matrix.h"
+#include "treecache.h"
+#include "routecache.h"
+#include "kdtree.h"
+#include "grid.h"
+#include "rtree.h"
+#include "greatcircle.h"
+#include "trigcoords.h"
+#include "metrics.h"
+#include "footwaygraph.h"
 
 TEST(graph, constructor) {
 	graph<int, int> G;
@@ -274,3 +297,1481 @@ TEST(graph, copyConstuctor) {
 	// 	cout << "True" << endl;
 	// }
 }
+
+TEST(csrgraph, emptyGraph) {
+	graph<int, int> G;
+	csrgraph<int, int> CG(G);
+    EXPECT_EQ(CG.NumVertices(), 0);
+    EXPECT_EQ(CG.NumEdges(), 0);
+    EXPECT_EQ(CG.neighbors(100).size(), 0);
+    EXPECT_EQ(CG.indexOf(100), -1);
+}
+
+TEST(csrgraph, matchesGraph) {
+	graph<int, int> G;
+
+    G.addVertex(300);
+    G.addVertex(100);
+    G.addVertex(200);
+    G.addVertex(400);
+    G.addEdge(100, 200, 10);
+    G.addEdge(100, 300, 30);
+    G.addEdge(100, 100, -999);
+    G.addEdge(200, 300, 20);
+    G.addEdge(300, 100, 5);
+
+	csrgraph<int, int> CG(G);
+    EXPECT_EQ(CG.NumVertices(), G.NumVertices());
+    EXPECT_EQ(CG.NumEdges(), G.NumEdges());
+    EXPECT_EQ(CG.getVertices(), G.getVertices());
+
+    // Same neighbors and weights for every vertex, including missing ones
+    for (int v : {50, 100, 200, 300, 400}) {
+    	EXPECT_EQ(CG.neighbors(v), G.neighbors(v));
+
+    	for (int n : {50, 100, 200, 300, 400}) {
+    		int expected = 0, actual = 0;
+    		EXPECT_EQ(CG.getWeight(v, n, actual), G.getWeight(v, n, expected));
+    		EXPECT_EQ(actual, expected);
+    	}
+    }
+
+    // Index functions
+    EXPECT_EQ(CG.indexOf(100), 0);
+    EXPECT_EQ(CG.indexOf(400), 3);
+    EXPECT_EQ(CG.indexOf(250), -1);
+    EXPECT_EQ(CG.vertexAt(CG.indexOf(300)), 300);
+    EXPECT_EQ(CG.edgesEnd(0) - CG.edgesBegin(0), 3);
+    EXPECT_EQ(CG.edgesEnd(3) - CG.edgesBegin(3), 0);
+    EXPECT_EQ(CG.edgeTarget(CG.edgesBegin(1)), CG.indexOf(300));
+    EXPECT_EQ(CG.edgeWeight(CG.edgesBegin(1)), 20);
+
+    // Frozen copy does not see later changes
+    G.addEdge(400, 100, 1);
+    EXPECT_EQ(CG.NumEdges(), 5);
+    EXPECT_EQ(CG.neighbors(400).size(), 0);
+}
+
+TEST(idmap, addAndTranslate) {
+	IDMapper mapper;
+    EXPECT_EQ(mapper.size(), 0u);
+
+    // Indices are handed out in insertion order
+    EXPECT_EQ(mapper.add(462010732LL), 0u);
+    EXPECT_EQ(mapper.add(-5LL), 1u);
+    EXPECT_EQ(mapper.add(9000000000LL), 2u);
+
+    // Duplicate ID keeps its index
+    EXPECT_EQ(mapper.add(-5LL), 1u);
+    EXPECT_EQ(mapper.size(), 3u);
+
+    EXPECT_EQ(mapper.toIndex(9000000000LL), 2u);
+    EXPECT_EQ(mapper.toID(0), 462010732LL);
+    EXPECT_TRUE(mapper.contains(-5LL));
+    EXPECT_FALSE(mapper.contains(7LL));
+
+    // Unknown IDs and indices throw like map::at()
+    EXPECT_THROW(mapper.toIndex(7LL), out_of_range);
+    EXPECT_THROW(mapper.toID(3), out_of_range);
+}
+
+TEST(footwaygraph, build) {
+	map<long long, Coordinates> Nodes;
+    vector<FootwayInfo> Footways(1, FootwayInfo(77));
+    IDMapper mapper;
+    vector<Coordinates> NodeCoords;
+    graph<uint32_t, double> G;
+    vector<uint32_t> from, to;
+
+    Nodes[30] = Coordinates(30, 41.8700, -87.6500);
+    Nodes[10] = Coordinates(10, 41.8710, -87.6500);
+    Nodes[20] = Coordinates(20, 41.8710, -87.6490);
+    Footways[0].Nodes = {10, 20, 30};
+
+    BuildFootwayGraph(Nodes, Footways, mapper, NodeCoords, G, from, to);
+
+    // Indices in ID order, one edge both ways per segment
+    EXPECT_EQ(mapper.toID(0), 10LL);
+    EXPECT_EQ(mapper.toID(2), 30LL);
+    EXPECT_EQ(NodeCoords[1].ID, 20LL);
+    EXPECT_EQ(from, vector<uint32_t>({0, 1}));
+    EXPECT_EQ(to, vector<uint32_t>({1, 2}));
+    EXPECT_EQ(G.NumVertices(), 3);
+    EXPECT_EQ(G.NumEdges(), 4);
+
+    double weight = 0;
+
+    EXPECT_TRUE(G.getWeight(2, 1, weight));
+    EXPECT_EQ(weight, MetricMiles<DistanceMetric>(Nodes[20], Nodes[30]));
+    EXPECT_FALSE(G.getWeight(0, 2, weight));
+}
+
+TEST(graph, forEachNeighbor) {
+	graph<int, int> G;
+
+    G.addVertex(100);
+    G.addVertex(200);
+    G.addVertex(300);
+    G.addEdge(100, 300, 30);
+    G.addEdge(100, 200, 10);
+    G.addEdge(100, 100, -999);
+    G.addEdge(200, 300, 20);
+
+	csrgraph<int, int> CG(G);
+
+    // Visits (neighbor, weight) in sorted order, same as neighbors()
+    vector<pair<int, int>> expected = {{100, -999}, {200, 10}, {300, 30}};
+    vector<pair<int, int>> visited;
+    vector<pair<int, int>> visitedCSR;
+
+    G.forEachNeighbor(100, [&](int n, int w) { visited.push_back(make_pair(n, w)); });
+    CG.forEachNeighbor(100, [&](int n, int w) { visitedCSR.push_back(make_pair(n, w)); });
+    EXPECT_EQ(visited, expected);
+    EXPECT_EQ(visitedCSR, expected);
+
+    // No neighbors and missing vertices never call the visitor
+    int calls = 0;
+    G.forEachNeighbor(300, [&](int, int) { calls++; });
+    G.forEachNeighbor(-999, [&](int, int) { calls++; });
+    CG.forEachNeighbor(300, [&](int, int) { calls++; });
+    CG.forEachNeighbor(-999, [&](int, int) { calls++; });
+    EXPECT_EQ(calls, 0);
+}
+
+//
+// buildTestGraph
+//
+// Small weighted graph used by the search tests:
+//
+//    1 --1-- 2 --1-- 3
+//    |               |
+//    4 ------5------ 5        6 --1-- 7  (separate component)
+//
+// Every edge is added both ways, like the footways in application.cpp.
+//
+static csrgraph<int, double> buildTestGraph() {
+	graph<int, double> G;
+
+    for (int v = 1; v <= 7; v++) {
+    	G.addVertex(v);
+    }
+
+    int edges[][3] = {{1, 2, 1}, {2, 3, 1}, {3, 5, 1}, {1, 4, 1}, {4, 5, 5}, {6, 7, 1}};
+
+    for (auto &edge : edges) {
+    	G.addEdge(edge[0], edge[1], edge[2]);
+    	G.addEdge(edge[1], edge[0], edge[2]);
+    }
+
+    return csrgraph<int, double>(G);
+}
+
+TEST(algs, dijkstraSingleSource) {
+	csrgraph<int, double> CG = buildTestGraph();
+    vector<double> distances;
+    vector<int> predecessors;
+
+    vector<int> visited = Dijkstra(CG, 1, distances, predecessors);
+    EXPECT_EQ(visited, vector<int>({1, 2, 4, 3, 5}));
+    EXPECT_EQ(distances[CG.indexOf(5)], 3);
+    EXPECT_EQ(predecessors[CG.indexOf(5)], CG.indexOf(3));
+    EXPECT_EQ(predecessors[CG.indexOf(1)], -1);
+    EXPECT_EQ(distances[CG.indexOf(6)], INF);
+}
+
+TEST(algs, dijkstraPath) {
+	csrgraph<int, double> CG = buildTestGraph();
+    vector<int> path;
+
+    EXPECT_EQ(DijkstraPath(CG, 4, 3, path), 3);
+    EXPECT_EQ(path, vector<int>({4, 1, 2, 3}));
+
+    EXPECT_EQ(DijkstraPath(CG, 2, 2, path), 0);
+    EXPECT_EQ(path, vector<int>({2}));
+
+    // Unreachable and missing vertices
+    EXPECT_EQ(DijkstraPath(CG, 1, 7, path), INF);
+    EXPECT_TRUE(path.empty());
+    EXPECT_EQ(DijkstraPath(CG, 1, 99, path), INF);
+    EXPECT_TRUE(path.empty());
+}
+
+TEST(algs, lazySearchState) {
+	csrgraph<int, double> CG = buildTestGraph();
+    SearchWorkspace state;
+    vector<int> visited;
+
+    // Stopping at 2 only touches 1's neighbors and 2's neighbors
+    DijkstraSearch(CG, CG.indexOf(1), CG.indexOf(2), state, visited);
+    EXPECT_EQ(visited.size(), 2);
+    EXPECT_TRUE(state.settled(CG.indexOf(2)));
+    EXPECT_FALSE(state.settled(CG.indexOf(4)));
+    EXPECT_EQ(state.distance(CG.indexOf(4)), 1);
+
+    // Vertices the search never reached read back as INF on demand
+    EXPECT_EQ(state.distance(CG.indexOf(5)), INF);
+    EXPECT_EQ(state.predecessor(CG.indexOf(5)), -1);
+    EXPECT_EQ(state.distance(CG.indexOf(7)), INF);
+}
+
+TEST(algs, workspaceReuse) {
+	csrgraph<int, double> CG = buildTestGraph();
+    SearchWorkspace state;
+    vector<int> path;
+
+    EXPECT_EQ(DijkstraPath(CG, 1, 5, path, state), 3);
+    EXPECT_TRUE(state.settled(CG.indexOf(3)));
+
+    // Nothing from the previous query leaks into the next one
+    EXPECT_EQ(DijkstraPath(CG, 6, 7, path, state), 1);
+    EXPECT_EQ(path, vector<int>({6, 7}));
+    EXPECT_FALSE(state.settled(CG.indexOf(3)));
+    EXPECT_EQ(state.distance(CG.indexOf(1)), INF);
+
+    EXPECT_EQ(DijkstraPath(CG, 7, 1, path, state), INF);
+    EXPECT_EQ(DijkstraPath(CG, 5, 4, path, state), 4);
+    EXPECT_EQ(path, vector<int>({5, 3, 2, 1, 4}));
+}
+
+//
+// buildRandomGraph
+//
+// Directed graph with n vertices and about n * degree random edges,
+// generated from a fixed seed so every run sees the same graph.
+//
+static csrgraph<int, double> buildRandomGraph(int n, int degree, unsigned seed) {
+	graph<int, double> G;
+
+    for (int v = 0; v < n; v++) {
+    	G.addVertex(v);
+    }
+
+    for (int i = 0; i < n * degree; i++) {
+    	seed = seed * 1103515245 + 12345;
+    	int from = (seed >> 8) % n;
+    	seed = seed * 1103515245 + 12345;
+    	int to = (seed >> 8) % n;
+    	seed = seed * 1103515245 + 12345;
+    	double weight = 0.5 + (seed >> 8) % 1000 / 100.0;
+
+    	G.addEdge(from, to, weight);
+    }
+
+    return csrgraph<int, double>(G);
+}
+
+TEST(csrgraph, reversed) {
+	csrgraph<int, double> CG = buildRandomGraph(50, 3, 7);
+	csrgraph<int, double> R = CG.reversed();
+
+    EXPECT_EQ(R.NumVertices(), CG.NumVertices());
+    EXPECT_EQ(R.NumEdges(), CG.NumEdges());
+
+    for (int from = 0; from < 50; from++) {
+    	for (int to = 0; to < 50; to++) {
+    		double forwardWeight = -1, reverseWeight = -1;
+    		EXPECT_EQ(CG.getWeight(from, to, forwardWeight), R.getWeight(to, from, reverseWeight));
+    		EXPECT_EQ(forwardWeight, reverseWeight);
+    	}
+    }
+
+    // Reversing twice gives back the same rows
+    csrgraph<int, double> RR = R.reversed();
+    for (int v = 0; v < 50; v++) {
+    	EXPECT_EQ(RR.neighbors(v), CG.neighbors(v));
+    }
+}
+
+TEST(algs, bidirectionalMatchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(200, 3, 11);
+	csrgraph<int, double> R = CG.reversed();
+    SearchWorkspace forward, backward;
+    vector<int> expectedPath, path;
+
+    for (int start = 0; start < 200; start += 7) {
+    	for (int dest = 0; dest < 200; dest += 3) {
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, forward);
+    		double actual = BidirectionalDijkstraPath(CG, R, start, dest, path, forward, backward);
+
+    		EXPECT_NEAR(actual, expected, 1e-9);
+    		EXPECT_EQ(path.empty(), expectedPath.empty());
+
+    		if (!path.empty()) {
+    			EXPECT_EQ(PathDistance(CG, path), actual);
+    			EXPECT_EQ(path.front(), start);
+    			EXPECT_EQ(path.back(), dest);
+    		}
+    	}
+    }
+
+    // Symmetric graph is its own reverse
+	csrgraph<int, double> footways = buildTestGraph();
+    EXPECT_EQ(BidirectionalDijkstraPath(footways, footways, 5, 4, path, forward, backward), 4);
+    EXPECT_EQ(path, vector<int>({5, 3, 2, 1, 4}));
+    EXPECT_EQ(BidirectionalDijkstraPath(footways, footways, 2, 2, path, forward, backward), 0);
+    EXPECT_EQ(path, vector<int>({2}));
+    EXPECT_EQ(BidirectionalDijkstraPath(footways, footways, 1, 7, path, forward, backward), INF);
+    EXPECT_TRUE(path.empty());
+}
+
+//
+// ZeroHeuristic
+//
+// Always 0, which turns A* back into plain Dijkstra.
+//
+struct ZeroHeuristic {
+	double operator()(int) const {
+		return 0;
+	}
+};
+
+TEST(algs, astarMatchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(200, 3, 5);
+    SearchWorkspace state;
+    vector<int> expectedPath, path;
+
+    for (int start = 0; start < 200; start += 11) {
+    	for (int dest = 0; dest < 200; dest += 3) {
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, state);
+    		double actual = AStarPath(CG, start, dest, ZeroHeuristic(), path, state);
+
+    		EXPECT_EQ(actual, expected);
+    		EXPECT_EQ(path, expectedPath);
+    	}
+    }
+}
+
+//
+// A* with MetricHeuristic<MetricT, NodePointsT> against Dijkstra, on a
+// 20x20 grid of footway nodes a few hundred feet apart whose edges are
+// weighted by MetricT like main() does.
+//
+template<typename MetricT, typename NodePointsT = MetricCoordinates<MetricT>>
+static void expectMetricAStar() {
+	const int side = 20;
+	graph<int, double> G;
+	vector<Coordinates> NodeCoords;
+	vector<uint32_t> from, to;
+	vector<double> miles;
+
+    for (int i = 0; i < side * side; i++) {
+    	double lat = 41.87 + (i / side) * 0.0004 + (i * 7 % 5) * 0.00003;
+    	double lon = -87.65 + (i % side) * 0.0005 + (i * 3 % 7) * 0.00002;
+
+    	NodeCoords.push_back(Coordinates(i, lat, lon));
+    	G.addVertex(i);
+    }
+
+    for (int i = 0; i < side * side; i++) {
+    	for (int j : {i + 1, i + side}) {
+    		if (j < side * side && !(j == i + 1 && j % side == 0) && i % 5 != 3) {
+    			from.push_back(i);
+    			to.push_back(j);
+    		}
+    	}
+    }
+
+    MetricDistances<MetricT>(NodeCoords, from, to, miles);
+
+    for (size_t e = 0; e < from.size(); e++) {
+    	G.addEdge(from[e], to[e], miles[e]);
+    	G.addEdge(to[e], from[e], miles[e]);
+    }
+
+	csrgraph<int, double> CG(G);
+    NodePointsT nodePoints(NodeCoords);
+    SearchWorkspace state;
+    vector<int> expectedPath, path;
+
+    for (int start = 0; start < side * side; start += 37) {
+    	for (int dest = 0; dest < side * side; dest += 13) {
+    		MetricHeuristic<MetricT, NodePointsT> heuristic(nodePoints, NodeCoords[dest]);
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, state);
+
+    		// Admissible: never more than the true remaining distance
+    		EXPECT_LE(heuristic(start), expected);
+    		EXPECT_EQ(AStarPath(CG, start, dest, heuristic, path, state), expected);
+    		EXPECT_EQ(path, expectedPath);
+    	}
+    }
+}
+
+TEST(algs, astarGreatCircle) {
+	expectMetricAStar<LawOfCosinesMetric, TrigCoordinates>();
+}
+
+TEST(algs, astarNearCoincidentNodes) {
+	//
+	// Two runs of footway nodes a centimeter apart, where acos rounds
+	// every edge weight to 0, leading toward a destination ~0.1 miles
+	// east.  The longer run gains more on the rounding, so it is the
+	// shortest route; the bound must not hide it behind the other one.
+	//
+	graph<int, double> G;
+	vector<Coordinates> NodeCoords;
+	vector<uint32_t> from, to;
+	vector<double> miles;
+	const int longRun = 40, shortRun = 20, dest = longRun + shortRun + 1;
+
+    for (int i = 0; i <= longRun; i++) {
+    	NodeCoords.push_back(Coordinates(i, 41.87, -87.65 + i * 5e-8));
+    }
+
+    for (int i = 1; i <= shortRun; i++) {
+    	NodeCoords.push_back(Coordinates(longRun + i, 41.87 + 5e-8, -87.65 + i * 5e-8));
+    }
+
+    NodeCoords.push_back(Coordinates(dest, 41.87, -87.648));
+
+    for (int i = 0; i < longRun; i++) {
+    	from.push_back(i);
+    	to.push_back(i + 1);
+    }
+
+    from.push_back(0);
+    to.push_back(longRun + 1);
+
+    for (int i = longRun + 1; i < longRun + shortRun; i++) {
+    	from.push_back(i);
+    	to.push_back(i + 1);
+    }
+
+    from.push_back(longRun);
+    to.push_back(dest);
+    from.push_back(longRun + shortRun);
+    to.push_back(dest);
+
+    MetricDistances<LawOfCosinesMetric>(NodeCoords, from, to, miles);
+
+    for (int i = 0; i <= dest; i++) {
+    	G.addVertex(i);
+    }
+
+    for (size_t e = 0; e < from.size(); e++) {
+    	G.addEdge(from[e], to[e], miles[e]);
+    	G.addEdge(to[e], from[e], miles[e]);
+    }
+
+	csrgraph<int, double> CG(G);
+    TrigCoordinates nodeTrig(NodeCoords);
+    GreatCircleHeuristic heuristic(nodeTrig, NodeCoords[dest]);
+    SearchWorkspace state;
+    vector<int> expectedPath, path;
+
+    for (int v = 0; v <= dest; v++) {
+    	EXPECT_LE(heuristic(v), DijkstraPath(CG, v, dest, expectedPath, state));
+    }
+
+    double expected = DijkstraPath(CG, 0, dest, expectedPath, state);
+
+    EXPECT_EQ(expectedPath.size(), (size_t) longRun + 2);
+    EXPECT_EQ(AStarPath(CG, 0, dest, heuristic, path, state), expected);
+    EXPECT_EQ(path, expectedPath);
+}
+
+TEST(alt, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(300, 3, 13);
+	csrgraph<int, double> R = CG.reversed();
+	ALTLandmarks<int> landmarks;
+    SearchWorkspace state;
+    vector<int> expectedPath, path;
+
+    landmarks.build(CG, R, 6);
+    EXPECT_EQ(landmarks.NumLandmarks(), 6);
+    EXPECT_TRUE(landmarks.matches(CG));
+
+    for (int start = 0; start < 300; start += 13) {
+    	for (int dest = 0; dest < 300; dest += 7) {
+    		ALTHeuristic<int> heuristic(landmarks, CG, start, dest);
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, state);
+
+    		EXPECT_LE(heuristic(start), expected);
+    		EXPECT_EQ(AStarPath(CG, start, dest, heuristic, path, state), expected);
+    		EXPECT_EQ(path, expectedPath);
+    	}
+    }
+
+    // Backward rows built in parallel come out the same
+    WorkStealingScheduler scheduler(3);
+    ALTLandmarks<int> parallelLandmarks;
+
+    parallelLandmarks.build(CG, R, 6, &scheduler);
+    EXPECT_EQ(parallelLandmarks.getLandmarks(), landmarks.getLandmarks());
+
+    for (int k = 0; k < 6; k++) {
+    	for (int v = 0; v < 300; v++) {
+    		EXPECT_EQ(parallelLandmarks.toLandmark(k, v), landmarks.toLandmark(k, v));
+    	}
+    }
+}
+
+TEST(alt, saveAndLoad) {
+	csrgraph<int, double> footways = buildTestGraph();
+	ALTLandmarks<int> landmarks, loaded, stale;
+    string filename = "testbench.landmarks";
+
+    // Symmetric graph passed as its own reverse
+    landmarks.build(footways, footways, 2);
+    EXPECT_EQ(landmarks.NumLandmarks(), 2);
+    EXPECT_EQ(landmarks.fromLandmark(0, footways.indexOf(6)), INFINITY);
+
+    ASSERT_TRUE(landmarks.save(filename));
+    ASSERT_TRUE(loaded.load(filename, footways));
+    EXPECT_EQ(loaded.getLandmarks(), landmarks.getLandmarks());
+
+    for (int k = 0; k < 2; k++) {
+    	for (int v = 0; v < footways.NumVertices(); v++) {
+    		EXPECT_EQ(loaded.fromLandmark(k, v), landmarks.fromLandmark(k, v));
+    		EXPECT_EQ(loaded.toLandmark(k, v), landmarks.fromLandmark(k, v));
+    	}
+    }
+
+    // Tables built on another graph are rejected
+    EXPECT_FALSE(stale.load(filename, buildRandomGraph(7, 2, 1)));
+    EXPECT_FALSE(stale.load("no-such-file.landmarks", footways));
+    EXPECT_EQ(stale.NumLandmarks(), 0);
+
+    // Corrupt header fields and landmark indices are rejected too: the
+    // landmark count, the symmetric flag, then the first landmark
+    for (int offset : {16, 20, 24}) {
+    	ASSERT_TRUE(landmarks.save(filename));
+
+    	fstream file(filename, ios::in | ios::out | ios::binary);
+    	int32_t corrupt = 1000000;
+
+    	file.seekp(offset);
+    	file.write((const char *) &corrupt, sizeof(corrupt));
+    	file.close();
+
+    	EXPECT_FALSE(stale.load(filename, footways)) << offset;
+    	EXPECT_EQ(stale.NumLandmarks(), 0);
+    }
+
+    remove(filename.c_str());
+}
+
+TEST(ch, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(300, 3, 17);
+	ContractionHierarchy<int> CH;
+    SearchWorkspace forward, backward;
+    vector<int> expectedPath, path;
+
+    CH.build(CG);
+
+    for (int start = 0; start < 300; start += 7) {
+    	for (int dest = 0; dest < 300; dest += 5) {
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, forward);
+    		double actual = CH.route(CG, start, dest, path, forward, backward);
+
+    		EXPECT_NEAR(actual, expected, 1e-9);
+    		EXPECT_EQ(path.empty(), expectedPath.empty());
+
+    		// Unpacked path is made of original edges and adds up
+    		if (!path.empty()) {
+    			EXPECT_EQ(path.front(), start);
+    			EXPECT_EQ(path.back(), dest);
+    			EXPECT_EQ(PathDistance(CG, path), actual);
+    		}
+    	}
+    }
+}
+
+TEST(ch, footways) {
+	csrgraph<int, double> footways = buildTestGraph();
+	ContractionHierarchy<int> CH;
+    SearchWorkspace forward, backward;
+    vector<int> path;
+
+    CH.build(footways);
+
+    EXPECT_EQ(CH.route(footways, 5, 4, path, forward, backward), 4);
+    EXPECT_EQ(path, vector<int>({5, 3, 2, 1, 4}));
+    EXPECT_EQ(CH.route(footways, 4, 4, path, forward, backward), 0);
+    EXPECT_EQ(path, vector<int>({4}));
+    EXPECT_EQ(CH.route(footways, 1, 6, path, forward, backward), INF);
+    EXPECT_TRUE(path.empty());
+    EXPECT_EQ(CH.route(footways, 1, 99, path, forward, backward), INF);
+}
+
+TEST(radixheap, popsInOrder) {
+	RadixHeap<int> heap;
+    vector<uint64_t> keys = {5, 3, 17, 3, 1024, 0, 99, 64, 65};
+    vector<uint64_t> popped;
+    bool pushedMore = false;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+    	heap.push(keys[i], (int) i);
+    }
+
+    EXPECT_EQ(heap.size(), keys.size());
+
+    // Dijkstra style: push larger keys while popping
+    while (!heap.empty()) {
+    	uint64_t key = heap.top().first;
+    	heap.pop();
+    	popped.push_back(key);
+
+    	if (key == 17 && !pushedMore) {
+    		pushedMore = true;
+    		heap.push(20, -1);
+    		heap.push(17, -1);
+    	}
+    }
+
+    EXPECT_EQ(popped, vector<uint64_t>({0, 3, 3, 5, 17, 17, 20, 64, 65, 99, 1024}));
+    EXPECT_THROW(heap.push(1000, 0), logic_error);
+
+    heap.clear();
+    heap.push(1, 0);
+    EXPECT_EQ(heap.top().first, 1u);
+
+    // popMin is top() and pop() in one, smallest value first on ties
+    heap.push(1, -3);
+    heap.push(4, -9);
+    EXPECT_EQ(heap.popMin(), make_pair((uint64_t) 1, -3));
+    EXPECT_EQ(heap.popMin(), make_pair((uint64_t) 1, 0));
+    EXPECT_EQ(heap.size(), 1u);
+}
+
+TEST(radixheap, fixedPointWeights) {
+	EXPECT_EQ(FixedPointWeights::toUnits(0), 0u);
+	EXPECT_EQ(FixedPointWeights::toUnits(0.25), 25000000u);
+	EXPECT_EQ(FixedPointWeights::toUnits(1.23456789004), 123456789u);
+	EXPECT_EQ(FixedPointWeights::toMiles(25000000), 0.25);
+	EXPECT_THROW(FixedPointWeights::toUnits(-1), out_of_range);
+	EXPECT_THROW(FixedPointWeights::toUnits(50), out_of_range);
+
+	// Two nodes at the same spot: acos can round to NaN or just below 0
+	EXPECT_EQ(FixedPointWeights::toUnits(NAN), 0u);
+	EXPECT_EQ(FixedPointWeights::toUnits(-1e-12), 0u);
+
+	graph<int, double> G;
+	vector<int> path;
+
+	for (int v = 1; v <= 4; v++) {
+		G.addVertex(v);
+	}
+
+	G.addEdge(1, 2, 0.5);
+	G.addEdge(2, 3, NAN);
+	G.addEdge(3, 4, 0.0);
+
+	csrgraph<int, double> CG(G);
+	FixedPointWeights fixedWeights(CG);
+
+	EXPECT_EQ(fixedWeights.weight(CG.edgesBegin(CG.indexOf(2))), 0u);
+	EXPECT_EQ(RadixDijkstraPath(CG, fixedWeights, 1, 4, path), 0.5);
+	EXPECT_EQ(path, vector<int>({1, 2, 3, 4}));
+}
+
+TEST(radixheap, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(300, 3, 42);
+	FixedPointWeights fixedWeights(CG);
+    SearchWorkspace state;
+    RadixHeap<int> queue;
+    vector<int> expectedPath, path;
+
+    for (int start = 0; start < 300; start += 7) {
+    	for (int dest = 0; dest < 300; dest += 5) {
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, state);
+    		double actual = RadixDijkstraPath(CG, fixedWeights, start, dest, path, state, queue);
+
+    		// Within the precision bound in radixheap.h
+    		EXPECT_NEAR(actual, expected, (path.size() + expectedPath.size()) * 0.5e-8);
+    		EXPECT_EQ(path.empty(), expectedPath.empty());
+
+    		if (!path.empty()) {
+    			EXPECT_EQ(path.front(), start);
+    			EXPECT_EQ(path.back(), dest);
+    			EXPECT_EQ(PathDistance(CG, path), actual);
+    		}
+    	}
+    }
+
+    csrgraph<int, double> footways = buildTestGraph();
+    FixedPointWeights footwayWeights(footways);
+
+    EXPECT_EQ(RadixDijkstraPath(footways, footwayWeights, 5, 4, path), 4);
+    EXPECT_EQ(RadixDijkstraPath(footways, footwayWeights, 1, 6, path), INF);
+    EXPECT_TRUE(path.empty());
+}
+
+TEST(daryheap, decreaseKey) {
+	IndexedDaryHeap<3> heap;
+
+    heap.clear(10);
+    heap.push(4, 7.0);
+    heap.push(2, 3.0);
+    heap.push(9, 5.0);
+    heap.push(1, 5.0);
+    heap.push(4, 1.0);  // decrease-key, no second entry
+
+    EXPECT_EQ(heap.size(), 4);
+    EXPECT_TRUE(heap.contains(4));
+    EXPECT_FALSE(heap.contains(0));
+    EXPECT_EQ(heap.pop(), make_pair(4, 1.0));
+    EXPECT_EQ(heap.pop(), make_pair(2, 3.0));
+    EXPECT_EQ(heap.pop(), make_pair(1, 5.0));  // ties go to smaller index
+    EXPECT_FALSE(heap.contains(1));
+    EXPECT_EQ(heap.pop(), make_pair(9, 5.0));
+    EXPECT_TRUE(heap.empty());
+
+    heap.push(3, 2.0);
+    heap.clear(10);
+    EXPECT_TRUE(heap.empty());
+    EXPECT_FALSE(heap.contains(3));
+}
+
+// Runs Dijkstra from every 11th vertex with the given queue and checks it
+// against the default binary heap
+template<typename QueueT>
+static void expectSameSearch(const csrgraph<int, double> &CG, QueueT &queue) {
+	SearchWorkspace state;
+    vector<double> expectedDistances, distances;
+    vector<int> expectedPredecessors, predecessors;
+
+    for (int start = 0; start < CG.NumVertices(); start += 11) {
+    	vector<int> expected = Dijkstra(CG, start, expectedDistances, expectedPredecessors);
+    	vector<int> visited = Dijkstra(CG, start, distances, predecessors, state, queue);
+
+    	EXPECT_EQ(visited, expected);
+    	EXPECT_EQ(distances, expectedDistances);
+    	EXPECT_EQ(predecessors, expectedPredecessors);
+    }
+}
+
+TEST(daryheap, matchesBinaryHeap) {
+	csrgraph<int, double> CG = buildRandomGraph(300, 3, 99);
+	IndexedDaryHeap<2> binary;
+	IndexedDaryHeap<4> quaternary;
+	IndexedDaryHeap<8> octonary;
+    SearchWorkspace state;
+    vector<int> path;
+
+    expectSameSearch(CG, binary);
+    expectSameSearch(CG, quaternary);
+    expectSameSearch(CG, octonary);
+
+    csrgraph<int, double> footways = buildTestGraph();
+
+    EXPECT_EQ(DijkstraPath(footways, 5, 4, path, state, quaternary), 4);
+    EXPECT_EQ(path, vector<int>({5, 3, 2, 1, 4}));
+}
+
+TEST(algs, queuePolicies) {
+	csrgraph<int, double> CG = buildRandomGraph(300, 3, 5);
+	PairingHeap pairing;
+	RadixHeapQueue radix;
+	BucketQueue bucket(CG);
+	BucketQueue narrowBucket(0.01, 10.5);
+
+    expectSameSearch(CG, pairing);
+    expectSameSearch(CG, radix);
+    expectSameSearch(CG, bucket);
+    expectSameSearch(CG, narrowBucket);
+
+    // Distances past the ring would alias with smaller ones
+    narrowBucket.clear(0);
+    EXPECT_THROW(narrowBucket.push(0, 20.0), logic_error);
+    EXPECT_THROW(BucketQueue(0, 1), invalid_argument);
+}
+
+TEST(pairingheap, decreaseKey) {
+	PairingHeap heap;
+    vector<int> order;
+
+    heap.clear(20);
+
+    for (int i = 0; i < 20; i++) {
+    	heap.push(i, 100 - i);
+    }
+
+    heap.push(15, 1);   // decrease-key on a buried node
+    heap.push(7, 1);    // tie with 15, smaller index first
+    heap.push(3, 500);  // not lower, ignored
+    EXPECT_EQ(heap.size(), 20);
+    EXPECT_EQ(heap.top(), make_pair(7, 1.0));
+
+    while (!heap.empty()) {
+    	order.push_back(heap.pop().first);
+    }
+
+    EXPECT_EQ(order, vector<int>({7, 15, 19, 18, 17, 16, 14, 13, 12, 11,
+    	10, 9, 8, 6, 5, 4, 3, 2, 1, 0}));
+    EXPECT_FALSE(heap.contains(7));
+}
+
+TEST(deltastep, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(400, 3, 11);
+	csrgraph<int, double> R = CG.reversed();
+    vector<double> expectedDistances, distances;
+    vector<int> expectedPredecessors, predecessors;
+
+    for (int start = 0; start < 400; start += 37) {
+    	vector<int> expected = Dijkstra(CG, start, expectedDistances, expectedPredecessors);
+
+    	for (int threads : {1, 2, 4}) {
+    		for (double delta : {0.0, 0.3, 2.0, 50.0}) {
+    			vector<int> visited = DeltaStepping(CG, R, start, distances,
+    				predecessors, delta, threads);
+
+    			EXPECT_EQ(visited, expected);
+    			EXPECT_EQ(distances, expectedDistances);
+    			EXPECT_EQ(predecessors, expectedPredecessors);
+    		}
+    	}
+    }
+}
+
+TEST(deltastep, footways) {
+	csrgraph<int, double> footways = buildTestGraph();
+    vector<double> distances;
+    vector<int> predecessors;
+
+    vector<int> visited = DeltaStepping(footways, footways, 5, distances, predecessors, 1.0, 3);
+
+    EXPECT_EQ(visited, vector<int>({5, 3, 2, 1, 4}));
+    EXPECT_EQ(distances[footways.indexOf(4)], 4);
+    EXPECT_EQ(distances[footways.indexOf(6)], INF);
+    EXPECT_EQ(predecessors[footways.indexOf(5)], -1);
+    EXPECT_EQ(predecessors[footways.indexOf(4)], footways.indexOf(1));
+
+    EXPECT_TRUE(DeltaStepping(footways, footways, 99, distances, predecessors).empty());
+    EXPECT_EQ(distances[0], INF);
+}
+
+TEST(batch, resultsInInputOrder) {
+	graph<uint32_t, double> G;
+	uint32_t seed = 3;
+
+    for (uint32_t v = 0; v < 200; v++) {
+    	G.addVertex(v);
+    }
+
+    for (int i = 0; i < 600; i++) {
+    	seed = seed * 1103515245 + 12345;
+    	uint32_t from = (seed >> 8) % 200;
+    	seed = seed * 1103515245 + 12345;
+    	uint32_t to = (seed >> 8) % 200;
+
+    	G.addEdge(from, to, 1 + (seed >> 8) % 50 / 10.0);
+    }
+
+    csrgraph<uint32_t, double> CG(G);
+    vector<Coordinates> NodeCoords(200);
+    vector<pair<uint32_t, uint32_t>> queries;
+
+    for (uint32_t i = 0; i < 500; i++) {
+    	queries.push_back(make_pair(i * 7 % 200, i * 13 % 200));
+    }
+
+    for (int threads : {1, 3}) {
+    	BatchRouter batch(CG, NodeCoords, ROUTE_DIJKSTRA, nullptr, nullptr, nullptr, threads);
+    	vector<RouteResult> results = batch.route(queries);
+
+    	EXPECT_EQ(batch.NumThreads(), threads);
+    	ASSERT_EQ(results.size(), queries.size());
+
+    	for (size_t i = 0; i < queries.size(); i++) {
+    		vector<uint32_t> expectedPath;
+    		double expected = DijkstraPath(CG, queries[i].first, queries[i].second, expectedPath);
+
+    		EXPECT_EQ(results[i].Distance, expected);
+    		EXPECT_EQ(results[i].Path, expectedPath);
+    	}
+    }
+
+    BatchRouter batch(CG, NodeCoords, ROUTE_DIJKSTRA);
+    EXPECT_TRUE(batch.route(vector<pair<uint32_t, uint32_t>>()).empty());
+}
+
+TEST(scheduler, runsEveryTaskOnce) {
+	WorkStealingScheduler scheduler(4);
+    vector<int> runs(1000, 0);
+    vector<int> lastWorker(1000, -1);
+
+    EXPECT_EQ(scheduler.NumWorkers(), 4);
+
+    for (size_t grain : {1, 7, 5000}) {
+    	scheduler.parallelFor(runs.size(), [&](size_t i, int worker) {
+    		runs[i]++;
+    		lastWorker[i] = worker;
+    	}, grain);
+    }
+
+    for (size_t i = 0; i < runs.size(); i++) {
+    	EXPECT_EQ(runs[i], 3);
+    	EXPECT_GE(lastWorker[i], 0);
+    	EXPECT_LT(lastWorker[i], 4);
+    }
+
+    // Counters add up to the work done
+    uint64_t tasks = 0;
+
+    for (const WorkerStats &stats : scheduler.stats()) {
+    	tasks += stats.Tasks;
+    }
+
+    EXPECT_EQ(tasks, 3000u);
+
+    scheduler.resetStats();
+    EXPECT_EQ(scheduler.stats()[0].Tasks, 0u);
+    scheduler.parallelFor(0, [&](size_t, int) { FAIL(); });
+}
+
+TEST(scheduler, stealsFromBusyWorkers) {
+	WorkStealingScheduler scheduler(4);
+    vector<int> owner(64, -1);
+
+    // The first chunk of worker 0 is slow, so the others should take
+    // over the rest of its deque
+    scheduler.parallelFor(64, [&](size_t i, int worker) {
+    	if (i == 0) {
+    		this_thread::sleep_for(chrono::milliseconds(50));
+    	}
+    	owner[i] = worker;
+    });
+
+    uint64_t steals = 0;
+
+    for (const WorkerStats &stats : scheduler.stats()) {
+    	steals += stats.Steals;
+    }
+
+    EXPECT_GT(steals, 0u);
+    EXPECT_EQ(owner[0], 0);
+}
+
+TEST(scheduler, rethrowsExceptions) {
+	WorkStealingScheduler scheduler(2);
+    int ran = 0;
+
+    EXPECT_THROW(scheduler.parallelFor(10, [&](size_t i, int) {
+    	if (i == 3) {
+    		throw runtime_error("task failed");
+    	}
+    }), runtime_error);
+
+    // Still usable afterwards
+    scheduler.parallelFor(5, [&](size_t, int) { ran++; }, 5);
+    EXPECT_EQ(ran, 5);
+}
+
+TEST(matrix, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(200, 3, 23);
+	ContractionHierarchy<int> CH;
+    WorkStealingScheduler scheduler(3);
+    SearchWorkspace state;
+    vector<int> sources, targets, path;
+
+    for (int v = 0; v < 200; v += 9) {
+    	sources.push_back(v);
+    }
+
+    for (int v = 3; v < 200; v += 13) {
+    	targets.push_back(v);
+    }
+
+    targets.push_back(999);  // Not in the graph
+
+    CH.build(CG);
+
+    DistanceMatrix serial = ComputeDistanceMatrix(CG, sources, targets);
+    DistanceMatrix parallel = ComputeDistanceMatrix(CG, sources, targets, &scheduler);
+    DistanceMatrix buckets = ComputeDistanceMatrix(CG, CH, sources, targets);
+
+    ASSERT_EQ(serial.NumRows(), (int) sources.size());
+    ASSERT_EQ(serial.NumCols(), (int) targets.size());
+
+    for (size_t i = 0; i < sources.size(); i++) {
+    	for (size_t j = 0; j < targets.size(); j++) {
+    		double expected = DijkstraPath(CG, sources[i], targets[j], path, state);
+
+    		EXPECT_EQ(serial.at(i, j), expected);
+    		EXPECT_EQ(parallel.at(i, j), expected);
+
+    		if (expected == INF) {
+    			EXPECT_EQ(buckets.at(i, j), INF);
+    		} else {
+    			EXPECT_NEAR(buckets.at(i, j), expected, 1e-9);
+    		}
+    	}
+    }
+}
+
+TEST(matrix, writeAndRead) {
+	csrgraph<int, double> footways = buildTestGraph();
+	vector<int> nodes = {1, 4, 6};
+    DistanceMatrix table = ComputeDistanceMatrix(footways, nodes, nodes);
+    DistanceMatrix loaded;
+    string filename = "testbench.matrix";
+
+    EXPECT_EQ(table.at(0, 1), 1);
+    EXPECT_EQ(table.at(1, 0), 1);
+    EXPECT_EQ(table.at(0, 2), INF);
+
+    ASSERT_TRUE(table.writeBinary(filename));
+    ASSERT_TRUE(loaded.readBinary(filename));
+    ASSERT_EQ(loaded.NumRows(), 3);
+    ASSERT_EQ(loaded.NumCols(), 3);
+
+    for (int i = 0; i < 3; i++) {
+    	for (int j = 0; j < 3; j++) {
+    		EXPECT_EQ(loaded.at(i, j), table.at(i, j));
+    	}
+    }
+
+    EXPECT_FALSE(loaded.readBinary("no-such-file.matrix"));
+    EXPECT_EQ(loaded.NumRows(), 3);
+
+    // Labels with commas are quoted, unreachable entries are "inf"
+    table.setLabels({"A", "B, C", "D"}, {"A", "B, C", "D"});
+    ASSERT_TRUE(table.writeCSV(filename));
+
+    ifstream file(filename);
+    string header, firstRow;
+
+    getline(file, header);
+    getline(file, firstRow);
+    EXPECT_EQ(header, ",A,\"B, C\",D");
+    EXPECT_EQ(firstRow.substr(0, 4), "A,0,");
+    EXPECT_EQ(firstRow.substr(firstRow.size() - 4), ",inf");
+
+    file.close();
+    remove(filename.c_str());
+}
+
+TEST(treecache, matchesDijkstra) {
+	csrgraph<int, double> CG = buildRandomGraph(150, 3, 29);
+	ShortestPathTreeCache<int> trees(2);
+    SearchWorkspace state;
+    vector<int> expectedPath, path;
+
+    for (int start : {4, 90, 4, 17, 90}) {
+    	const ShortestPathTree *tree = trees.find(start);
+
+    	if (tree == nullptr) {
+    		tree = &trees.build(CG, start, state);
+    	}
+
+    	for (int dest = 0; dest < 150; dest += 3) {
+    		double expected = DijkstraPath(CG, start, dest, expectedPath, state);
+
+    		EXPECT_EQ(tree->pathTo(CG, dest, path), expected);
+    		EXPECT_EQ(path, expectedPath);
+    	}
+    }
+
+    // 4 hit, then 17 evicted 90 (least recently used), so 90 missed again
+    EXPECT_EQ(trees.hits(), 1u);
+    EXPECT_EQ(trees.misses(), 4u);
+    EXPECT_EQ(trees.size(), 2);
+    EXPECT_EQ(trees.find(4), nullptr);
+    EXPECT_NE(trees.find(17), nullptr);
+
+    trees.clear();
+    EXPECT_EQ(trees.size(), 0);
+    EXPECT_EQ(trees.find(17), nullptr);
+}
+
+TEST(treecache, routerRepeatedStart) {
+	graph<uint32_t, double> G;
+
+    for (uint32_t v = 0; v < 100; v++) {
+    	G.addVertex(v);
+    }
+
+    for (uint32_t v = 0; v < 100; v++) {
+    	G.addEdge(v, (v * 37 + 11) % 100, 1 + v % 7);
+    	G.addEdge(v, (v * 53 + 29) % 100, 2 + v % 5);
+    }
+
+    csrgraph<uint32_t, double> CG(G);
+    vector<Coordinates> NodeCoords(100);
+    Router router(CG, NodeCoords, ROUTE_DIJKSTRA);
+    vector<uint32_t> expectedPath, path;
+
+    router.cacheTrees(4);
+
+    for (uint32_t dest = 0; dest < 100; dest++) {
+    	double expected = DijkstraPath(CG, 7u, dest, expectedPath);
+
+    	EXPECT_EQ(router.route(7, dest, path), expected);
+    	EXPECT_EQ(path, expectedPath);
+    }
+
+    // Tree built on the second query, every later one was a hit
+    EXPECT_EQ(router.treeCache().size(), 1);
+    EXPECT_EQ(router.treeCache().hits(), 98u);
+}
+
+TEST(routecache, leastRecentlyUsed) {
+	RouteCache routes(2);
+	CachedRoute route;
+
+    route.Distance = 1.5;
+    route.Path = {3, 4, 5};
+
+    routes.setGraph(buildTestGraph());
+    EXPECT_EQ(routes.find(0, 1), nullptr);
+
+    routes.insert(0, 1, route);
+    route.Distance = 2.5;
+    routes.insert(1, 0, route);
+
+    ASSERT_NE(routes.find(0, 1), nullptr);
+    EXPECT_EQ(routes.find(0, 1)->Distance, 1.5);
+    EXPECT_EQ(routes.find(0, 1)->Path, vector<uint32_t>({3, 4, 5}));
+
+    // (1, 0) is now the least recently used, so it goes first
+    route.Distance = INF;
+    route.Path.clear();
+    routes.insert(2, 2, route);
+
+    EXPECT_EQ(routes.size(), 2);
+    EXPECT_EQ(routes.find(1, 0), nullptr);
+    ASSERT_NE(routes.find(2, 2), nullptr);
+    EXPECT_EQ(routes.find(2, 2)->Distance, INF);
+    EXPECT_EQ(routes.hits(), 5u);
+    EXPECT_EQ(routes.misses(), 2u);
+
+    // Same graph again keeps the routes, a different one drops them
+    routes.setGraph(buildTestGraph());
+    EXPECT_EQ(routes.size(), 2);
+    routes.setGraph(buildRandomGraph(7, 2, 1));
+    EXPECT_EQ(routes.size(), 0);
+    EXPECT_EQ(routes.find(0, 1), nullptr);
+}
+
+//
+// Footways of random nodes around campus for the spatial index tests,
+// with some nodes shared between footways and some at the same spot.
+//
+static void buildRandomFootways(int numNodes, unsigned seed, IDMapper &mapper,
+vector<Coordinates> &NodeCoords, vector<FootwayInfo> &Footways) {
+	for (int i = 0; i < numNodes; i++) {
+    	seed = seed * 1103515245 + 12345;
+    	double lat = 41.86 + (seed >> 8) % 10000 / 500000.0;
+    	seed = seed * 1103515245 + 12345;
+    	double lon = -87.66 + (seed >> 8) % 10000 / 400000.0;
+
+    	// Every 50th node duplicates the position of the one before
+    	if (i % 50 == 49) {
+    		lat = NodeCoords.back().Lat;
+    		lon = NodeCoords.back().Lon;
+    	}
+
+    	mapper.add(1000 + i);
+    	NodeCoords.push_back(Coordinates(1000 + i, lat, lon));
+    }
+
+    for (int start = 0; start < numNodes; start += 10) {
+    	FootwayInfo footway(start);
+
+    	// Overlaps the next footway by one node
+    	for (int i = start; i <= start + 10 && i < numNodes; i++) {
+    		footway.Nodes.push_back(1000 + (i * 7) % numNodes);
+    	}
+
+    	Footways.push_back(footway);
+    }
+}
+
+//
+// Checks a footway index against the linear scan it replaces, for random
+// queries in and around the map and right on top of nodes.
+//
+template<typename IndexT>
+static void expectSameNearest(double spread) {
+	IDMapper mapper;
+	vector<Coordinates> NodeCoords;
+    vector<FootwayInfo> Footways;
+
+    buildRandomFootways(2000, 41, mapper, NodeCoords, Footways);
+
+    IndexT footwayIndex(Footways, mapper, NodeCoords);
+    unsigned seed = 43;
+
+    EXPECT_EQ(footwayIndex.NumPoints(), 2000);
+
+    for (int q = 0; q < 500; q++) {
+    	seed = seed * 1103515245 + 12345;
+    	double lat = 41.87 + ((seed >> 8) % 10000 / 10000.0 - 0.5) * spread;
+    	seed = seed * 1103515245 + 12345;
+    	double lon = -87.647 + ((seed >> 8) % 10000 / 10000.0 - 0.5) * spread;
+
+    	// Queries right on a node too, including the duplicated spots
+    	if (q % 5 == 0) {
+    		lat = NodeCoords[q * 3].Lat;
+    		lon = NodeCoords[q * 3].Lon;
+    	}
+
+    	uint32_t expected = NO_INDEX;
+    	double closest = INF;
+
+    	for (const FootwayInfo &footway : Footways) {
+    		for (long long id : footway.Nodes) {
+    			uint32_t index = mapper.toIndex(id);
+    			double miles = distBetween2Points(lat, lon, NodeCoords[index].Lat, NodeCoords[index].Lon);
+
+    			if (miles < closest) {
+    				closest = miles;
+    				expected = index;
+    			}
+    		}
+    	}
+
+    	EXPECT_EQ(footwayIndex.nearest(lat, lon), expected);
+    }
+
+    EXPECT_EQ(IndexT().nearest(41.87, -87.65), NO_INDEX);
+}
+
+TEST(kdtree, matchesLinearScan) {
+	expectSameNearest<FootwayKdTree>(0.03);
+    expectSameNearest<FootwayKdTree>(1);
+}
+
+TEST(grid, matchesLinearScan) {
+	expectSameNearest<FootwayGrid>(0.03);
+    expectSameNearest<FootwayGrid>(1);
+}
+
+TEST(rtree, matchesLinearScan) {
+	IDMapper mapper;
+	vector<Coordinates> NodeCoords;
+    vector<FootwayInfo> Footways;
+
+    buildRandomFootways(2000, 41, mapper, NodeCoords, Footways);
+
+    FootwayRTree footwaySegments(Footways, mapper, NodeCoords);
+    unsigned seed = 47;
+
+    EXPECT_EQ(footwaySegments.NumSegments(), 2000 - 1);
+
+    for (int q = 0; q < 500; q++) {
+    	seed = seed * 1103515245 + 12345;
+    	double lat = 41.87 + ((seed >> 8) % 10000 / 10000.0 - 0.5) * 0.03;
+    	seed = seed * 1103515245 + 12345;
+    	double lon = -87.647 + ((seed >> 8) % 10000 / 10000.0 - 0.5) * 0.03;
+
+    	// Closest point of every segment, on the same flat projection.
+    	// Segments sharing the closest node may tie, so only the point
+    	// itself is compared.
+    	double milesPerLat = EarthRadiusMiles * TrigPI / 180.0;
+    	double milesPerLon = milesPerLat * cos(lat * TrigPI / 180.0);
+    	double closest = INF;
+    	double expectedLat = 0, expectedLon = 0;
+
+    	for (const FootwayInfo &footway : Footways) {
+    		for (int i = 0; i + 1 < (int) footway.Nodes.size(); i++) {
+    			uint32_t from = mapper.toIndex(footway.Nodes[i]);
+    			uint32_t to = mapper.toIndex(footway.Nodes[i + 1]);
+    			double ax = (NodeCoords[from].Lon - lon) * milesPerLon;
+    			double ay = (NodeCoords[from].Lat - lat) * milesPerLat;
+    			double dx = (NodeCoords[to].Lon - lon) * milesPerLon - ax;
+    			double dy = (NodeCoords[to].Lat - lat) * milesPerLat - ay;
+    			double t = 0;
+
+    			if (dx * dx + dy * dy > 0) {
+    				t = min(max(-(ax * dx + ay * dy) / (dx * dx + dy * dy), 0.0), 1.0);
+    			}
+
+    			double miles = sqrt((ax + t * dx) * (ax + t * dx) + (ay + t * dy) * (ay + t * dy));
+
+    			if (miles < closest) {
+    				closest = miles;
+    				expectedLat = NodeCoords[from].Lat + t * (NodeCoords[to].Lat - NodeCoords[from].Lat);
+    				expectedLon = NodeCoords[from].Lon + t * (NodeCoords[to].Lon - NodeCoords[from].Lon);
+    			}
+    		}
+    	}
+
+    	SegmentSnap snap;
+
+    	ASSERT_TRUE(footwaySegments.nearest(lat, lon, snap));
+    	EXPECT_NEAR(snap.Miles, closest, 1e-12);
+    	EXPECT_NEAR(snap.Lat, expectedLat, 1e-9);
+    	EXPECT_NEAR(snap.Lon, expectedLon, 1e-9);
+    	EXPECT_GE(snap.Fraction, 0.0);
+    	EXPECT_LE(snap.Fraction, 1.0);
+    }
+
+    SegmentSnap snap;
+
+    EXPECT_FALSE(FootwayRTree().nearest(41.87, -87.65, snap));
+    EXPECT_EQ(snap.From, NO_INDEX);
+}
+
+TEST(rtree, routeSnapped) {
+	graph<uint32_t, double> G;
+
+    // 0 -1- 1 -2- 2 -3- 3, both ways
+    for (uint32_t v = 0; v < 4; v++) {
+    	G.addVertex(v);
+    }
+
+    for (uint32_t v = 0; v < 3; v++) {
+    	G.addEdge(v, v + 1, v + 1);
+    	G.addEdge(v + 1, v, v + 1);
+    }
+
+    csrgraph<uint32_t, double> CG(G);
+    vector<Coordinates> NodeCoords(4);
+    Router router(CG, NodeCoords, ROUTE_CH);
+    SegmentSnap start, dest;
+    vector<uint32_t> path;
+
+    start.From = 0;
+    start.To = 1;
+    start.Length = 1;
+    start.Fraction = 0.5;
+    dest.From = 3;
+    dest.To = 2;
+    dest.Length = 3;
+    dest.Fraction = 0.75;
+
+    // Half of 0-1, all of 1-2, a quarter of 2-3
+    EXPECT_EQ(router.routeSnapped(start, dest, path), 3.25);
+    EXPECT_EQ(path, vector<uint32_t>({1, 2}));
+    EXPECT_EQ(router.routeSnapped(dest, start, path), 3.25);
+    EXPECT_EQ(path, vector<uint32_t>({2, 1}));
+
+    // Same segment, given in opposite directions: straight along it
+    start.From = 1;
+    start.To = 2;
+    start.Length = 2;
+    start.Fraction = 0.2;
+    dest.From = 2;
+    dest.To = 1;
+    dest.Length = 2;
+    dest.Fraction = 0.5;
+
+    EXPECT_DOUBLE_EQ(router.routeSnapped(start, dest, path), 0.6);
+    EXPECT_TRUE(path.empty());
+
+    // No snap at all
+    EXPECT_EQ(router.routeSnapped(SegmentSnap(), dest, path), INF);
+    EXPECT_TRUE(path.empty());
+}
+
+TEST(greatcircle, matchesDistBetween2Points) {
+	IDMapper mapper;
+	vector<Coordinates> NodeCoords;
+    vector<FootwayInfo> Footways;
+
+    // Odd # of points, so the SIMD loops leave some over
+    buildRandomFootways(1003, 53, mapper, NodeCoords, Footways);
+
+    GreatCirclePoints points(NodeCoords);
+    vector<uint32_t> from, to;
+    vector<double> miles;
+
+    EXPECT_EQ(points.NumPoints(), 1003);
+
+    // Bit for bit, including the NaN of points on top of each other
+    points.distancesFrom(NodeCoords[48], miles);
+    ASSERT_EQ(miles.size(), NodeCoords.size());
+
+    for (size_t i = 0; i < NodeCoords.size(); i++) {
+    	double expected = distBetween2Points(NodeCoords[48].Lat, NodeCoords[48].Lon,
+    	NodeCoords[i].Lat, NodeCoords[i].Lon);
+
+    	EXPECT_EQ(memcmp(&miles[i], &expected, sizeof(double)), 0) << i;
+    }
+
+    for (const FootwayInfo &footway : Footways) {
+    	for (int i = 0; i + 1 < (int) footway.Nodes.size(); i++) {
+    		from.push_back(mapper.toIndex(footway.Nodes[i]));
+    		to.push_back(mapper.toIndex(footway.Nodes[i + 1]));
+    	}
+    }
+
+    points.distancesBetween(from, to, miles);
+    ASSERT_EQ(miles.size(), from.size());
+
+    for (size_t i = 0; i < from.size(); i++) {
+    	double expected = distBetween2Points(NodeCoords[from[i]].Lat, NodeCoords[from[i]].Lon,
+    	NodeCoords[to[i]].Lat, NodeCoords[to[i]].Lon);
+
+    	EXPECT_EQ(memcmp(&miles[i], &expected, sizeof(double)), 0) << i;
+    }
+
+    points.distancesBetween(vector<uint32_t>(), vector<uint32_t>(), miles);
+    EXPECT_TRUE(miles.empty());
+}
+
+TEST(trigcoords, distances) {
+	IDMapper mapper;
+	vector<Coordinates> NodeCoords;
+    vector<FootwayInfo> Footways;
+
+    buildRandomFootways(500, 59, mapper, NodeCoords, Footways);
+
+    TrigCoordinates nodeTrig(NodeCoords);
+
+    EXPECT_EQ(nodeTrig.NumPoints(), 500);
+
+    for (int i = 0; i < 500; i += 7) {
+    	for (int j = 0; j < 500; j += 3) {
+    		double expected = distBetween2Points(NodeCoords[i].Lat, NodeCoords[i].Lon,
+    		NodeCoords[j].Lat, NodeCoords[j].Lon);
+    		double miles = nodeTrig.greatCircleMiles(i, j);
+
+    		// Bit for bit, NaN included
+    		EXPECT_EQ(memcmp(&miles, &expected, sizeof(double)), 0) << i << " " << j;
+
+    		// Within the rounding of the acos, which is up to ~10cm for
+    		// points on top of each other; the chord gives exactly 0 there
+    		if (NodeCoords[i].Lat == NodeCoords[j].Lat && NodeCoords[i].Lon == NodeCoords[j].Lon) {
+    			EXPECT_EQ(nodeTrig.chordMiles(i, j), 0.0);
+    		} else {
+    			EXPECT_NEAR(nodeTrig.chordMiles(i, j), expected, 1e-5);
+    		}
+    	}
+    }
+
+    // The chord still resolves points a centimeter apart
+    TrigPoint a(41.87, -87.65);
+    TrigPoint b(41.87 + 1e-7, -87.65);
+
+    EXPECT_EQ(chordMiles(a, a), 0.0);
+    EXPECT_NEAR(chordMiles(a, b), 3963.1 * 1e-7 * 3.14159265 / 180.0, 1e-12);
+    EXPECT_NEAR(a.Unit[0] * a.Unit[0] + a.Unit[1] * a.Unit[1] + a.Unit[2] * a.Unit[2], 1.0, 1e-15);
+}
+
+TEST(metrics, astarMatchesDijkstra) {
+	expectMetricAStar<LawOfCosinesMetric>();
+    expectMetricAStar<HaversineMetric>();
+    expectMetricAStar<EquirectangularMetric>();
+    expectMetricAStar<VincentyMetric>();
+}
+
+TEST(metrics, distances) {
+	Coordinates a(1, 41.8708, -87.6505);
+	Coordinates b(2, 41.8686, -87.6474);
+
+	// The default is distBetween2Points itself
+	EXPECT_EQ(MetricMiles<LawOfCosinesMetric>(a, b),
+    distBetween2Points(a.Lat, a.Lon, b.Lat, b.Lon));
+
+    // Same sphere: agree to well under a millimeter (1e-9 miles ~ 1.6 um)
+    double haversine = MetricMiles<HaversineMetric>(a, b);
+
+    EXPECT_NEAR(MetricMiles<LawOfCosinesMetric>(a, b), haversine, 1e-6);
+    EXPECT_NEAR(MetricMiles<EquirectangularMetric>(a, b), haversine, 1e-9);
+    EXPECT_EQ(MetricMiles<HaversineMetric>(a, a), 0.0);
+    EXPECT_EQ(MetricMiles<EquirectangularMetric>(a, a), 0.0);
+    EXPECT_EQ(MetricMiles<VincentyMetric>(a, a), 0.0);
+
+    // Short way around the date line (to within the rounded pi of
+    // dist.cpp, which makes 360 degrees not quite a full turn)
+    EXPECT_NEAR(MetricMiles<EquirectangularMetric>(Coordinates(3, 0, 179.9), Coordinates(4, 0, -179.9)),
+    MetricMiles<HaversineMetric>(Coordinates(3, 0, 179.9), Coordinates(4, 0, -179.9)), 1e-4);
+
+    // Vincenty's own example, Flinders Peak to Buninyong: 54972.271 m
+    Coordinates flinders(5, -(37 + 57 / 60.0 + 3.72030 / 3600), 144 + 25 / 60.0 + 29.52440 / 3600);
+    Coordinates buninyong(6, -(37 + 39 / 60.0 + 10.15610 / 3600), 143 + 55 / 60.0 + 35.38390 / 3600);
+
+    EXPECT_NEAR(MetricMiles<VincentyMetric>(flinders, buninyong) * 1609.344, 54972.271, 1e-3);
+}
@@ -0,0 +1,226 @@
+// treecache.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// Cache of whole shortest path trees, keyed by their start vertex.
+//
+// A point-to-point search throws its work away once the destination is
+// found.  When many queries leave from the same place (a kiosk in the
+// lobby, or someone trying several destinations in a row), it pays to run
+// Dijkstra from that start to the end once and keep the distances and
+// predecessors: every later query from there is a lookup plus a walk back
+// along the predecessors.
+//
+// The cache holds at most Capacity trees and forgets the least recently
+// used one first.  Each tree takes about 12 bytes per vertex of the graph.
+//
+// Example:
+//    ShortestPathTreeCache<uint32_t> trees(4);
+//    const ShortestPathTree *tree = trees.find(startIndex);
+//    if (tree == nullptr)
+//        tree = &trees.build(CG, startIndex, state);
+//    double miles = tree->pathTo(CG, destIndex, path);
+//
+
+#pragma once
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+#include "csrgraph.h"
+#include "algs.h"
+
+using namespace std;
+
+//
+// ShortestPathTree
+//
+// Result of one full Dijkstra: Distances[i] is the distance from Start to
+// index i (INF if unreachable) and Predecessors[i] the index before it on
+// the path (-1 for Start and unreachable vertices).
+//
+struct ShortestPathTree {
+	int Start;
+	vector<double> Distances;
+	vector<int> Predecessors;
+
+	//
+	// pathTo
+	//
+	// Same answer DijkstraPath gives from Start: the distance to
+	// destIndex, with path filled with the vertices along the way.  If
+	// destIndex is unreachable (or not an index of G), INF is returned and
+	// path is empty.
+	//
+	template<typename VertexT>
+	double pathTo(const csrgraph<VertexT, double> &G, int destIndex,
+	vector<VertexT> &path) const {
+		path.clear();
+
+		if (destIndex < 0 || destIndex >= (int) Distances.size() ||
+		Distances[destIndex] == INF) {
+			return INF;
+		}
+
+		for (int index = destIndex; index != -1; index = Predecessors[index]) {
+			path.push_back(G.vertexAt(index));
+		}
+
+		reverse(path.begin(), path.end());
+
+		return Distances[destIndex];
+	}
+};
+
+template<typename VertexT>
+class ShortestPathTreeCache {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	int Capacity;
+	list<ShortestPathTree> Trees;  // Most recently used first
+	unordered_map<int, list<ShortestPathTree>::iterator> ByStart;
+	uint64_t nHits;
+	uint64_t nMisses;
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	//
+	// Cache holding at most capacity trees; 0 turns it off (find always
+	// misses and build keeps nothing).
+	//
+	explicit ShortestPathTreeCache(int capacity = 0) {
+		Capacity = max(capacity, 0);
+		nHits = 0;
+		nMisses = 0;
+	}
+
+	// Copies start out empty: ByStart's iterators point into other's list
+	ShortestPathTreeCache(const ShortestPathTreeCache &other) {
+		Capacity = other.Capacity;
+		nHits = 0;
+		nMisses = 0;
+	}
+
+	ShortestPathTreeCache& operator=(const ShortestPathTreeCache &other) {
+		clear();
+		Capacity = other.Capacity;
+		nHits = 0;
+		nMisses = 0;
+		return *this;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int capacity() const {
+		return Capacity;
+	}
+
+	int size() const {
+		return (int) ByStart.size();
+	}
+
+	uint64_t hits() const {
+		return nHits;
+	}
+
+	uint64_t misses() const {
+		return nMisses;
+	}
+
+	//
+	// find
+	//
+	// The cached tree rooted at startIndex, or nullptr.  A hit makes the
+	// tree the most recently used one.
+	//
+	const ShortestPathTree* find(int startIndex) {
+		auto found = ByStart.find(startIndex);
+
+		if (found == ByStart.end()) {
+			nMisses++;
+			return nullptr;
+		}
+
+		nHits++;
+		Trees.splice(Trees.begin(), Trees, found->second);
+
+		return &Trees.front();
+	}
+
+	//
+	// build
+	//
+	// Runs Dijkstra from startIndex over all of G, caches the tree
+	// (evicting the least recently used one if the cache is full) and
+	// returns it.  state is the caller's reusable workspace.  With a
+	// capacity of 0 the tree is returned but not kept: it stays valid
+	// until the next call to build.
+	//
+	const ShortestPathTree& build(const csrgraph<VertexT, double> &G,
+	int startIndex, SearchWorkspace &state) {
+		auto found = ByStart.find(startIndex);
+
+		if (found != ByStart.end()) {
+			Trees.splice(Trees.begin(), Trees, found->second);
+			return Trees.front();
+		}
+
+		// Reuse the evicted tree's arrays rather than allocating new ones
+		if (Trees.empty() || (int) Trees.size() < Capacity) {
+			Trees.push_front(ShortestPathTree());
+		} else {
+			if (Capacity > 0) {
+				ByStart.erase(Trees.back().Start);
+			}
+
+			Trees.splice(Trees.begin(), Trees, prev(Trees.end()));
+		}
+
+		ShortestPathTree &tree = Trees.front();
+		vector<int> visited;
+
+		tree.Start = startIndex;
+		tree.Distances.assign(G.NumVertices(), INF);
+		tree.Predecessors.assign(G.NumVertices(), -1);
+
+		if (startIndex >= 0 && startIndex < G.NumVertices()) {
+			DijkstraSearch(G, startIndex, -1, state, visited);
+
+			for (int index : visited) {
+				tree.Distances[index] = state.distance(index);
+				tree.Predecessors[index] = state.predecessor(index);
+			}
+		}
+
+		if (Capacity > 0) {
+			ByStart[startIndex] = Trees.begin();
+		}
+
+		return tree;
+	}
+
+	//
+	// clear
+	//
+	// Forgets every tree, e.g. after the graph has changed.  The hit and
+	// miss counters are kept.
+	//
+	void clear() {
+		Trees.clear();
+		ByStart.clear();
+	}
+};
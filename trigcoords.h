@@ -0,0 +1,163 @@
+// trigcoords.h
+// Author: Timothy Villaraza
+//
+// University of Illinois at Chicago
+// CS 251: Fall 2020
+// Project #7 - Openstreet Maps
+//
+// TrigCoordinates keeps every node's coordinates in the forms distance
+// math needs: radians, the sines and cosines of latitude and longitude,
+// and the point on the unit sphere (earth-centered, earth-fixed).  Node
+// coordinates never change once the map is read, so these are worked out
+// once per node instead of on every distBetween2Points call.
+//
+// Two distances come straight from those forms:
+//
+//    greatCircleMiles  the dot product of the unit vectors and an acos,
+//                      bit for bit what distBetween2Points returns
+//    chordMiles        the straight line between the unit vectors turned
+//                      into an angle with asin (the haversine formula);
+//                      also accurate for points a few centimeters apart,
+//                      where the acos above rounds to millimeters or NaN
+//
+// Points are stored together, one TrigPoint per node, for lookups one
+// node at a time (e.g. A*).  GreatCirclePoints in greatcircle.h keeps
+// separate arrays instead, for batches.
+//
+// Example:
+//    TrigCoordinates nodeTrig(NodeCoords);
+//    double miles = greatCircleMiles(nodeTrig[from], nodeTrig[to]);
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "osm.h"
+
+using namespace std;
+
+// Same constants as distBetween2Points, see dist.cpp
+const double TrigPI = 3.14159265;
+const double EarthRadiusMiles = 3963.1;
+
+//
+// TrigPoint
+//
+// One point in every form.  Unit = (CosLat CosLon, CosLat SinLon, SinLat).
+//
+struct TrigPoint {
+	double LatRad;
+	double LonRad;
+	double SinLat;
+	double CosLat;
+	double SinLon;
+	double CosLon;
+	double Unit[3];
+
+	TrigPoint() {
+		LatRad = LonRad = 0;
+		SinLat = SinLon = 0;
+		CosLat = CosLon = 1;
+		Unit[0] = 1;
+		Unit[1] = Unit[2] = 0;
+	}
+
+	// (lat, lon) in degrees
+	TrigPoint(double lat, double lon) {
+		LatRad = lat * TrigPI / 180.0;
+		LonRad = lon * TrigPI / 180.0;
+		SinLat = sin(LatRad);
+		CosLat = cos(LatRad);
+		SinLon = sin(LonRad);
+		CosLon = cos(LonRad);
+		Unit[0] = CosLat * CosLon;
+		Unit[1] = CosLat * SinLon;
+		Unit[2] = SinLat;
+	}
+
+	explicit TrigPoint(const Coordinates &point)
+		: TrigPoint(point.Lat, point.Lon) {
+	}
+};
+
+//
+// greatCircleMiles
+//
+// distBetween2Points(a, b) without any trig but the acos: the same
+// products, summed in the same order.
+//
+inline double greatCircleMiles(const TrigPoint &a, const TrigPoint &b) {
+	return EarthRadiusMiles * acos(a.Unit[0] * b.CosLat * b.CosLon
+	+ a.Unit[1] * b.CosLat * b.SinLon
+	+ a.Unit[2] * b.SinLat);
+}
+
+//
+// chordMiles
+//
+// Great circle distance from the chord between the unit vectors:
+// 2 asin(chord / 2) is the angle between them.  Never NaN.
+//
+inline double chordMiles(const TrigPoint &a, const TrigPoint &b) {
+	double dx = a.Unit[0] - b.Unit[0];
+	double dy = a.Unit[1] - b.Unit[1];
+	double dz = a.Unit[2] - b.Unit[2];
+	double halfChord = sqrt(dx * dx + dy * dy + dz * dz) / 2;
+
+	return EarthRadiusMiles * 2 * asin(min(halfChord, 1.0));
+}
+
+class TrigCoordinates {
+	private:
+	////////////////////////////////////////////////////////////////////////////
+	// Private Member Variables
+	////////////////////////////////////////////////////////////////////////////
+
+	vector<TrigPoint> Points;  // [index] = NodeCoords[index]
+
+	public:
+	////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	////////////////////////////////////////////////////////////////////////////
+
+	TrigCoordinates() {
+	}
+
+	//
+	// One TrigPoint per element of NodeCoords, at the same index.
+	//
+	explicit TrigCoordinates(const vector<Coordinates> &NodeCoords) {
+		Points.reserve(NodeCoords.size());
+
+		for (const Coordinates &point : NodeCoords) {
+			Points.push_back(TrigPoint(point));
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Public Functions
+	////////////////////////////////////////////////////////////////////////////
+
+	int NumPoints() const {
+		return (int) Points.size();
+	}
+
+	const TrigPoint& operator[](size_t index) const {
+		return Points[index];
+	}
+
+	//
+	// Distances in miles between nodes # from and # to; see
+	// greatCircleMiles and chordMiles above.
+	//
+	double greatCircleMiles(size_t from, size_t to) const {
+		return ::greatCircleMiles(Points[from], Points[to]);
+	}
+
+	double chordMiles(size_t from, size_t to) const {
+		return ::chordMiles(Points[from], Points[to]);
+	}
+};